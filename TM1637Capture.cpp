@@ -0,0 +1,144 @@
+//  TM1637 Tiny Display
+//  Capture of the frames sent to a display
+//
+//  Author: Jason A. Cox - @jasonacox - https://github.com/jasonacox
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2.1 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+
+#include <TM1637Capture.h>
+
+#if TM1637_ENABLE_CAPTURE
+
+#include <Arduino.h>
+
+TM1637Capture::TM1637Capture()
+{
+  m_digits = 0;
+  clear();
+}
+
+void TM1637Capture::clear()
+{
+  m_head = 0;
+  m_count = 0;
+  m_dropped = 0;
+}
+
+void TM1637Capture::record(uint32_t ms, const uint8_t frame[], uint8_t digits, uint8_t brightness)
+{
+  if (digits > CAPTURE_DIGITS) digits = CAPTURE_DIGITS;
+  TM1637CaptureEntry &e = m_entries[m_head];
+  e.ms = ms;
+  memset(e.frame, 0, CAPTURE_DIGITS);
+  memcpy(e.frame, frame, digits);
+  e.brightness = brightness;
+  m_digits = digits;
+
+  m_head = (m_head + 1) % CAPTURE_LENGTH;
+  if (m_count < CAPTURE_LENGTH) m_count++;
+  else m_dropped++;
+}
+
+void TM1637Capture::record(uint32_t ms, uint8_t brightness)
+{
+  uint8_t frame[CAPTURE_DIGITS] = { 0 };
+  if (m_count > 0) memcpy(frame, entry(m_count - 1).frame, CAPTURE_DIGITS);
+  record(ms, frame, m_digits ? m_digits : CAPTURE_DIGITS, brightness);
+}
+
+unsigned int TM1637Capture::count() const
+{
+  return m_count;
+}
+
+unsigned long TM1637Capture::dropped() const
+{
+  return m_dropped;
+}
+
+uint8_t TM1637Capture::digits() const
+{
+  return m_digits;
+}
+
+const TM1637CaptureEntry &TM1637Capture::entry(unsigned int i) const
+{
+  // The oldest entry is the one written count entries ago
+  return m_entries[(m_head + CAPTURE_LENGTH - m_count + i) % CAPTURE_LENGTH];
+}
+
+size_t TM1637Capture::print(Print &out, const char *name) const
+{
+  static const char hex[] = "0123456789abcdef";
+  size_t n = 0;
+
+  // Same layout as the code generated by the animator (HGFEDCBA bit order)
+  n += out.print("/* Animation Data - HGFEDCBA Map */\r\n");
+  n += out.print("const uint8_t ");
+  n += out.print(name);
+  n += out.print("[");
+  n += out.print(m_count);
+  n += out.print("][");
+  n += out.print(m_digits);
+  n += out.print("] = {");
+  for (unsigned int i = 0; i < m_count; i++) {
+    const TM1637CaptureEntry &e = entry(i);
+    n += out.print("\r\n  { ");
+    for (uint8_t k = 0; k < m_digits; k++) {
+      char byte[] = { '0', 'x', hex[e.frame[k] >> 4], hex[e.frame[k] & 0x0f], 0 };
+      if (k > 0) n += out.print(", ");
+      n += out.print(byte);
+    }
+    // Comments must not contain commas, the animator splits frames at them
+    n += out.print(i + 1 < m_count ? " },  // Frame " : " }   // Frame ");
+    n += out.print(i);
+    n += out.print(" - ");
+    n += out.print(e.ms - entry(0).ms);
+    n += out.print(" ms");
+    if (!(e.brightness & 0x08)) n += out.print(" (off)");
+    else {
+      n += out.print(" (brightness ");
+      n += out.print(e.brightness & 0x07);
+      n += out.print(")");
+    }
+  }
+  n += out.print("\r\n};\r\n");
+  return n;
+}
+
+size_t TM1637Capture::printJSON(Print &out) const
+{
+  size_t n = 0;
+  n += out.print("{\"digits\":");
+  n += out.print(m_digits);
+  n += out.print(",\"dropped\":");
+  n += out.print(m_dropped);
+  n += out.print(",\"frames\":[");
+  for (unsigned int i = 0; i < m_count; i++) {
+    const TM1637CaptureEntry &e = entry(i);
+    if (i > 0) n += out.print(",");
+    n += out.print("{\"ms\":");
+    n += out.print(e.ms - entry(0).ms);
+    n += out.print(",\"brightness\":");
+    n += out.print(e.brightness & 0x07);
+    n += out.print((e.brightness & 0x08) ? ",\"on\":true" : ",\"on\":false");
+    n += out.print(",\"segments\":[");
+    for (uint8_t k = 0; k < m_digits; k++) {
+      if (k > 0) n += out.print(",");
+      n += out.print(e.frame[k]);
+    }
+    n += out.print("]}");
+  }
+  n += out.print("]}\r\n");
+  return n;
+}
+
+#endif // TM1637_ENABLE_CAPTURE
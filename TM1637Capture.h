@@ -0,0 +1,123 @@
+//  TM1637 Tiny Display
+//  Capture of the frames sent to a display
+//
+//  Author: Jason A. Cox - @jasonacox - https://github.com/jasonacox
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2.1 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  Usage (requires TM1637_ENABLE_CAPTURE=1):
+//
+//    TM1637Capture capture;
+//    display.setCapture(&capture);
+//    ...                             // Run the sequence to record
+//    capture.print(Serial);          // C array for examples/7-segment-animator.html
+//    capture.printJSON(Serial);      // Frames with timing and brightness
+
+#ifndef __TM1637CAPTURE__
+#define __TM1637CAPTURE__
+
+#include <inttypes.h>
+#include <stddef.h>
+#include "TM1637TinyDisplayConfig.h"
+
+#if TM1637_ENABLE_CAPTURE
+
+// Frames kept in the ring buffer (the oldest frame is overwritten when full)
+#ifndef CAPTURE_LENGTH
+#define CAPTURE_LENGTH  16
+#endif
+
+// Frame size of an entry (large enough for the 6-digit display)
+#define CAPTURE_DIGITS  6
+
+class Print;
+
+// One update of the display
+struct TM1637CaptureEntry {
+  uint32_t ms;                      // millis() (or the time source) when the update was sent
+  uint8_t frame[CAPTURE_DIGITS];    // Segments as shown, leftmost digit first
+  uint8_t brightness;               // Brightness (bits 0-2) and on (bit 3)
+};
+
+// Ring buffer of everything a display sends. Attach it with setCapture() and
+// every full or partial frame update and every brightness change is recorded
+// with its time stamp. The frames are the digits shown, leftmost first and
+// before any flip or mirror of the orientation, with blinking applied, so a
+// flipped and an unflipped display export the same frames.
+class TM1637Capture {
+
+public:
+  //! Initialize an empty capture
+  TM1637Capture();
+
+  //! Remove all entries
+  void clear();
+
+  //! Record a frame update
+  //!
+  //! @param ms Time stamp of the update
+  //! @param frame Array of segment values, leftmost digit first
+  //! @param digits Number of digits in frame (1 to CAPTURE_DIGITS)
+  //! @param brightness Brightness sent with the frame
+  void record(uint32_t ms, const uint8_t frame[], uint8_t digits, uint8_t brightness);
+
+  //! Record a brightness change (repeats the newest frame)
+  //!
+  //! @param ms Time stamp of the change
+  //! @param brightness The new brightness
+  void record(uint32_t ms, uint8_t brightness);
+
+  //! Number of entries in the capture
+  unsigned int count() const;
+
+  //! Number of entries overwritten because the capture was full
+  unsigned long dropped() const;
+
+  //! Number of digits of the recorded display
+  uint8_t digits() const;
+
+  //! Entry of the capture
+  //!
+  //! @param i Index of the entry (0 - oldest, count() - 1 - newest)
+  const TM1637CaptureEntry &entry(unsigned int i) const;
+
+  //! Write the capture as a C array in the format of the animator
+  //!
+  //! Writes "const uint8_t name[count][digits] = { ... };" with one frame per
+  //! line, which examples/7-segment-animator.html (7-segment-animator6.html for
+  //! 6 digits) accepts as pasted animation data. The time of each frame and the
+  //! brightness are added as comments.
+  //!
+  //! @param out Where to write the array (e.g. Serial)
+  //! @param name Name of the array
+  //! @return Number of characters written
+  size_t print(Print &out, const char *name = "ANIMATION") const;
+
+  //! Write the capture as JSON
+  //!
+  //! {"digits":4,"dropped":0,"frames":[{"ms":0,"brightness":7,"on":true,
+  //! "segments":[63,6,91,79]},...]} with the time relative to the oldest entry.
+  //!
+  //! @param out Where to write the JSON (e.g. Serial)
+  //! @return Number of characters written
+  size_t printJSON(Print &out) const;
+
+private:
+  TM1637CaptureEntry m_entries[CAPTURE_LENGTH];
+  unsigned long m_dropped;
+  unsigned int m_head;      // Next entry to write
+  unsigned int m_count;
+  uint8_t m_digits;
+};
+
+#endif // TM1637_ENABLE_CAPTURE
+
+#endif // __TM1637CAPTURE__
@@ -0,0 +1,396 @@
+//  TM1637 Tiny Display
+//  Display service with a command queue
+//
+//  Author: Jason A. Cox - @jasonacox - https://github.com/jasonacox
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2.1 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  The service owns a display and is the only code that talks to it. Other
+//  code (tasks, ISRs, loop()) posts small fixed-size commands that return
+//  immediately. The service executes them in order, skipping commands that are
+//  superseded by a newer one already waiting, and keeps non-blocking animations
+//  running with Animate().
+//
+//  Usage (include the display header first):
+//
+//    #include <TM1637TinyDisplay.h>
+//    #include <TM1637DisplayService.h>
+//
+//    TM1637TinyDisplay display(CLK, DIO);
+//    TM1637DisplayService<TM1637TinyDisplay> service(display);
+//
+//    setup():  display.begin();
+//              service.begin();          // ESP32: runs the service in its own task
+//    anywhere: service.showNumber(42);
+//    loop():   service.run();            // Other boards: run from loop()
+
+#ifndef __TM1637DISPLAYSERVICE__
+#define __TM1637DISPLAYSERVICE__
+
+#include <Arduino.h>
+#include "TM1637TinyDisplayConfig.h"
+
+#if !TM1637_ENABLE_ANIMATION
+#error "TM1637DisplayService.h requires TM1637_ENABLE_ANIMATION=1"
+#endif
+
+#ifndef SERVICE_QUEUE_LENGTH
+#define SERVICE_QUEUE_LENGTH    8     // Commands waiting for the service
+#endif
+#ifndef SERVICE_TEXT_LENGTH
+#define SERVICE_TEXT_LENGTH     24    // Longest string in a command (longer strings are cut)
+#endif
+
+#define SERVICE_STACK_SIZE      2048  // ESP32 task stack in bytes
+
+// Command types
+#define SERVICE_CLEAR           0
+#define SERVICE_NUMBER          1
+#define SERVICE_STRING          2
+#define SERVICE_ANIMATION       3
+#define SERVICE_BRIGHTNESS      4
+
+// Statistics of the service queue
+struct TM1637ServiceStats {
+  unsigned long posted;         // Commands accepted
+  unsigned long executed;       // Commands run on the display
+  unsigned long coalesced;      // Commands skipped because a newer one superseded them
+  unsigned long dropped;        // Commands rejected because the queue was full
+  unsigned long maxLatencyUs;   // Longest time from post to execution
+  unsigned long totalLatencyUs; // Sum of post to execution times (average = total / executed)
+  uint8_t depth;                // Commands waiting now
+  uint8_t maxDepth;             // Most commands waiting at once
+};
+
+template<class Display>
+class TM1637DisplayService {
+
+public:
+  //! Initialize a service for a display
+  //!
+  //! @param display The display owned by the service. Call display.begin() first
+  //!                and do not call the display directly afterwards.
+  TM1637DisplayService(Display &display) : m_display(display)
+  {
+    m_head = 0;
+    m_count = 0;
+    m_text[0] = 0;
+#ifdef ESP32
+    m_mux = portMUX_INITIALIZER_UNLOCKED;
+    m_task = nullptr;
+#endif
+    resetStats();
+  }
+
+#ifdef ESP32
+  //! Start the service in its own FreeRTOS task
+  //!
+  //! The task sleeps until a command is posted or the next animation frame is due.
+  //!
+  //! @param priority FreeRTOS priority of the task
+  //! @param core CPU core to run the task on (tskNO_AFFINITY for any)
+  //! @return true if the task was created
+  bool begin(UBaseType_t priority = 1, BaseType_t core = tskNO_AFFINITY)
+  {
+    return xTaskCreatePinnedToCore(task, "TM1637", SERVICE_STACK_SIZE, this,
+      priority, &m_task, core) == pdPASS;
+  }
+#endif
+
+  //! Show a number (right aligned, without leading zeros)
+  //!
+  //! @return false if the queue is full and the command was dropped
+  //!         (a full queue keeps the newest content and brightness commands)
+  bool showNumber(long num)
+  {
+    Command cmd;
+    cmd.type = SERVICE_NUMBER;
+    cmd.number = num;
+    return post(cmd);
+  }
+
+  //! Show a string, scrolling it if it is longer than the display
+  //!
+  //! The string is copied into the command (up to SERVICE_TEXT_LENGTH characters).
+  //!
+  //! @return false if the queue is full and the command was dropped
+  bool showString(const char s[])
+  {
+    Command cmd;
+    cmd.type = SERVICE_STRING;
+    strncpy(cmd.text, s, SERVICE_TEXT_LENGTH);
+    cmd.text[SERVICE_TEXT_LENGTH] = 0;
+    return post(cmd);
+  }
+
+  //! Start a non-blocking animation
+  //!
+  //! The animation data is not copied and must stay valid while it is shown.
+  //!
+  //! @return false if the queue is full and the command was dropped
+  bool startAnimation(const uint8_t (*data)[MAXDIGITS], unsigned int frames, unsigned int ms = 10,
+    bool usePROGMEM = false)
+  {
+    Command cmd;
+    cmd.type = SERVICE_ANIMATION;
+    cmd.animation.data = data;
+    cmd.animation.frames = frames;
+    cmd.animation.ms = ms;
+    cmd.animation.usePROGMEM = usePROGMEM;
+    return post(cmd);
+  }
+
+  //! Clear the display
+  //!
+  //! @return false if the queue is full and the command was dropped
+  bool clear()
+  {
+    Command cmd;
+    cmd.type = SERVICE_CLEAR;
+    return post(cmd);
+  }
+
+  //! Set the brightness of the display
+  //!
+  //! @return false if the queue is full and the command was dropped
+  bool setBrightness(uint8_t brightness, bool on = true)
+  {
+    Command cmd;
+    cmd.type = SERVICE_BRIGHTNESS;
+    cmd.brightness.level = brightness;
+    cmd.brightness.on = on;
+    return post(cmd);
+  }
+
+  //! Execute waiting commands and advance animations
+  //!
+  //! Called by the service task on ESP32. On other boards call it regularly from
+  //! loop(). A content command (number, string, animation, clear) is skipped if a
+  //! newer content command is already waiting, and likewise for brightness.
+  void run()
+  {
+    Command cmd;
+    bool superseded;
+    while (pop(cmd, superseded)) {
+      if (superseded) continue;
+      unsigned long latency = micros() - cmd.postedUs;
+      execute(cmd);
+      LockState state = lock();
+      m_stats.executed++;
+      m_stats.totalLatencyUs += latency;
+      if (latency > m_stats.maxLatencyUs) m_stats.maxLatencyUs = latency;
+      unlock(state);
+    }
+    m_display.Animate();
+  }
+
+  //! Returns a copy of the queue statistics
+  TM1637ServiceStats getStats()
+  {
+    LockState state = lock();
+    TM1637ServiceStats stats = m_stats;
+    stats.depth = m_count;
+    unlock(state);
+    return stats;
+  }
+
+  //! Reset the queue statistics
+  void resetStats()
+  {
+    LockState state = lock();
+    memset(&m_stats, 0, sizeof(m_stats));
+    unlock(state);
+  }
+
+private:
+  struct Command {
+    unsigned long postedUs;
+    uint8_t type;
+    union {
+      long number;
+      char text[SERVICE_TEXT_LENGTH + 1];
+      struct {
+        const uint8_t (*data)[MAXDIGITS];
+        unsigned int frames;
+        unsigned int ms;
+        bool usePROGMEM;
+      } animation;
+      struct {
+        uint8_t level;
+        bool on;
+      } brightness;
+    };
+  };
+
+  // Commands that replace the effect of earlier commands of the same group
+  static uint8_t group(uint8_t type)
+  {
+    return type == SERVICE_BRIGHTNESS ? 1 : 0;
+  }
+
+  bool post(Command &cmd)
+  {
+    cmd.postedUs = micros();
+    LockState state = lock();
+    if (m_count >= SERVICE_QUEUE_LENGTH) {
+      // Full - replace the newest waiting command that this one supersedes
+      for (uint8_t i = m_count; i > 0; i--) {
+        Command &waiting = m_queue[(m_head + i - 1) % SERVICE_QUEUE_LENGTH];
+        if (group(waiting.type) == group(cmd.type)) {
+          waiting = cmd;
+          m_stats.posted++;
+          m_stats.coalesced++;
+          unlock(state);
+          wake();
+          return true;
+        }
+      }
+      m_stats.dropped++;
+      unlock(state);
+      return false;
+    }
+    m_queue[(m_head + m_count) % SERVICE_QUEUE_LENGTH] = cmd;
+    m_count++;
+    m_stats.posted++;
+    if (m_count > m_stats.maxDepth) m_stats.maxDepth = m_count;
+    unlock(state);
+    wake();
+    return true;
+  }
+
+  bool pop(Command &cmd, bool &superseded)
+  {
+    LockState state = lock();
+    if (m_count == 0) {
+      unlock(state);
+      return false;
+    }
+    cmd = m_queue[m_head];
+    m_head = (m_head + 1) % SERVICE_QUEUE_LENGTH;
+    m_count--;
+
+    // Look for a newer command of the same group still waiting
+    superseded = false;
+    for (uint8_t i = 0; i < m_count; i++) {
+      if (group(m_queue[(m_head + i) % SERVICE_QUEUE_LENGTH].type) == group(cmd.type)) {
+        superseded = true;
+        m_stats.coalesced++;
+        break;
+      }
+    }
+    unlock(state);
+    return true;
+  }
+
+  void execute(const Command &cmd)
+  {
+    if (cmd.type != SERVICE_BRIGHTNESS) m_display.stopAnimation();
+
+    switch (cmd.type) {
+      case SERVICE_CLEAR:
+        m_display.clear();
+        break;
+      case SERVICE_NUMBER:
+        m_display.showNumber(cmd.number);
+        break;
+      case SERVICE_STRING:
+        // Keep the text for the non-blocking scroll
+        strcpy(m_text, cmd.text);
+#if TM1637_ENABLE_SCROLL
+        // Shows short strings directly
+        m_display.startStringScroll(m_text);
+#else
+        m_display.showString(m_text);
+#endif
+        break;
+      case SERVICE_ANIMATION:
+        m_display.startAnimation(cmd.animation.data, cmd.animation.frames, cmd.animation.ms,
+          cmd.animation.usePROGMEM);
+        break;
+      case SERVICE_BRIGHTNESS:
+        m_display.setBrightness(cmd.brightness.level, cmd.brightness.on);
+        break;
+    }
+  }
+
+#ifdef ESP32
+  static void task(void *arg)
+  {
+    TM1637DisplayService *service = (TM1637DisplayService *)arg;
+    for (;;) {
+      service->run();
+      unsigned long wait = service->m_display.nextDeadlineMs();
+      ulTaskNotifyTake(pdTRUE, wait == NO_DEADLINE ? portMAX_DELAY : pdMS_TO_TICKS(wait));
+    }
+  }
+
+  // The critical section nests and works in an ISR
+  typedef uint8_t LockState;
+  LockState lock() { portENTER_CRITICAL_SAFE(&m_mux); return 0; }
+  void unlock(LockState) { portEXIT_CRITICAL_SAFE(&m_mux); }
+
+  void wake()
+  {
+    if (m_task == nullptr) return;
+    if (xPortInIsrContext()) {
+      BaseType_t woken = pdFALSE;
+      vTaskNotifyGiveFromISR(m_task, &woken);
+      if (woken) portYIELD_FROM_ISR();
+    }
+    else {
+      xTaskNotifyGive(m_task);
+    }
+  }
+#else
+  // lock() returns the interrupt state of the caller (on the stack, so an ISR
+  // posting in between cannot overwrite it) and unlock() restores it. Posting
+  // from an ISR or with interrupts already disabled leaves them disabled.
+#if defined(__AVR__)
+  typedef uint8_t LockState;
+  LockState lock() { LockState state = SREG; cli(); return state; }
+  void unlock(LockState state) { SREG = state; }
+#elif defined(ESP8266)
+  typedef uint32_t LockState;
+  LockState lock() { return xt_rsil(15); }
+  void unlock(LockState state) { xt_wsr_ps(state); }
+#elif defined(__arm__)
+  // Cortex-M: PRIMASK is the interrupt mask
+  typedef uint32_t LockState;
+  LockState lock()
+  {
+    LockState state;
+    __asm__ volatile ("mrs %0, primask" : "=r" (state));
+    __asm__ volatile ("cpsid i" ::: "memory");
+    return state;
+  }
+  void unlock(LockState state) { __asm__ volatile ("msr primask, %0" :: "r" (state) : "memory"); }
+#else
+  // No way to read the interrupt state - only post from code with interrupts enabled
+  typedef uint8_t LockState;
+  LockState lock() { noInterrupts(); return 0; }
+  void unlock(LockState) { interrupts(); }
+#endif
+  void wake() {}
+#endif
+
+  Display &m_display;
+  Command m_queue[SERVICE_QUEUE_LENGTH];
+  char m_text[SERVICE_TEXT_LENGTH + 1];
+  TM1637ServiceStats m_stats;
+  uint8_t m_head;
+  volatile uint8_t m_count;
+#ifdef ESP32
+  portMUX_TYPE m_mux;
+  TaskHandle_t m_task;
+#endif
+};
+
+#endif // __TM1637DISPLAYSERVICE__
@@ -0,0 +1,428 @@
+//  TM1637 Tiny Display
+//  Font shared by the display classes
+//
+//  Author: Jason A. Cox - @jasonacox - https://github.com/jasonacox
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2.1 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+
+#include <TM1637Font.h>
+#include <Arduino.h>
+#ifdef __AVR__
+#include <avr/pgmspace.h>
+#elif defined(ESP8266) || defined(ESP32)
+#include <pgmspace.h>
+#elif !defined(pgm_read_byte)
+#define pgm_read_byte(addr)                                                    \
+  (*(const unsigned char *)(addr)) // workaround for non-AVR
+#endif
+
+//
+//      A
+//     ---
+//  F |   | B
+//     -G-
+//  E |   | C
+//     ---
+//      D
+// ASCII Map - Index 0 starts at ASCII FONT_FIRST_CHAR (32, or 0 with the full font)
+const uint8_t TM1637Font::asciiToSegment[] PROGMEM = {
+#if TM1637_ENABLE_FULL_FONT
+   // 000 - 031 (Control characters)
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+#endif
+   0b00000000, // 032 (Space)
+   0b00000110, // 033 !
+   0b00100010, // 034 "
+   0b01000001, // 035 #
+   0b01101101, // 036 $
+   0b01010010, // 037 %
+   0b01111100, // 038 &
+   0b00000010, // 039 '
+   0b00111001, // 040 (
+   0b00001111, // 041 )
+   0b00100001, // 042 *
+   0b01110000, // 043 +
+   0b00001000, // 044 ,
+   0b01000000, // 045 -
+   0b00001000, // 046 .
+   0b01010010, // 047 /
+   0b00111111, // 048 0
+   0b00000110, // 049 1
+   0b01011011, // 050 2
+   0b01001111, // 051 3
+   0b01100110, // 052 4
+   0b01101101, // 053 5
+   0b01111101, // 054 6
+   0b00000111, // 055 7
+   0b01111111, // 056 8
+   0b01101111, // 057 9
+   0b01001000, // 058 :
+   0b01001000, // 059 ;
+   0b01100001, // 060 <
+   0b01001000, // 061 =
+   0b01000011, // 062 >
+   0b01010011, // 063 ?
+   0b01111011, // 064 @
+   0b01110111, // 065 A
+   0b01111100, // 066 B
+   0b00111001, // 067 C
+   0b01011110, // 068 D
+   0b01111001, // 069 E
+   0b01110001, // 070 F
+   0b00111101, // 071 G
+   0b01110110, // 072 H
+   0b00000110, // 073 I
+   0b00011110, // 074 J
+   0b01110010, // 075 K
+   0b00111000, // 076 L
+   0b00110011, // 077 M (For display use Mm)
+   0b00110111, // 078 N
+   0b00111111, // 079 O
+   0b01110011, // 080 P
+   0b01100111, // 081 Q
+   0b00110001, // 082 R
+   0b01101101, // 083 S
+   0b01111000, // 084 T
+   0b00111110, // 085 U
+   0b00111110, // 086 V
+   0b00111100, // 087 W (For display use Ww)
+   0b01110110, // 088 X
+   0b01101110, // 089 Y
+   0b01011011, // 090 Z
+   0b00111001, // 091 [
+   0b01100100, // 092 (backslash)
+   0b00001111, // 093 ]
+   0b00100011, // 094 ^
+   0b00001000, // 095 _
+   0b00100000, // 096 `
+   0b01011111, // 097 a
+   0b01111100, // 098 b
+   0b01011000, // 099 c
+   0b01011110, // 100 d
+   0b01111011, // 101 e
+   0b01110001, // 102 f
+   0b01101111, // 103 g
+   0b01110100, // 104 h
+   0b00000100, // 105 i
+   0b00001110, // 106 j
+   0b01110000, // 107 k
+   0b00011000, // 108 l
+   0b00100111, // 109 m (For display use nn)
+   0b01010100, // 110 n
+   0b01011100, // 111 o
+   0b01110011, // 112 p
+   0b01100111, // 113 q
+   0b01010000, // 114 r
+   0b01101101, // 115 s
+   0b01111000, // 116 t
+   0b00011100, // 117 u
+   0b00011100, // 118 v
+   0b00011110, // 119 w (For display use uu) 
+   0b01110110, // 120 x
+   0b01101110, // 121 y
+   0b01011011, // 122 z
+   0b01000110, // 123 {
+   0b00110000, // 124 |
+   0b01110000, // 125 }
+   0b01000000, // 126 ~
+   0b00000000, // 127
+#if TM1637_ENABLE_FULL_FONT
+   // 128 - 175
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0b01100011, // 176 (Degree)
+   // 177 - 255
+      0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+#endif
+};
+
+#if TM1637_ENABLE_FLIP
+// Orientation Maps - Index is the segment data without decimal point (XGFEDCBA)
+// Rotate 180 degrees: A<->D, B<->E, C<->F
+const uint8_t TM1637Font::rotateSegments[] PROGMEM = {
+  0x00, 0x08, 0x10, 0x18, 0x20, 0x28, 0x30, 0x38,
+  0x01, 0x09, 0x11, 0x19, 0x21, 0x29, 0x31, 0x39,
+  0x02, 0x0a, 0x12, 0x1a, 0x22, 0x2a, 0x32, 0x3a,
+  0x03, 0x0b, 0x13, 0x1b, 0x23, 0x2b, 0x33, 0x3b,
+  0x04, 0x0c, 0x14, 0x1c, 0x24, 0x2c, 0x34, 0x3c,
+  0x05, 0x0d, 0x15, 0x1d, 0x25, 0x2d, 0x35, 0x3d,
+  0x06, 0x0e, 0x16, 0x1e, 0x26, 0x2e, 0x36, 0x3e,
+  0x07, 0x0f, 0x17, 0x1f, 0x27, 0x2f, 0x37, 0x3f,
+  0x40, 0x48, 0x50, 0x58, 0x60, 0x68, 0x70, 0x78,
+  0x41, 0x49, 0x51, 0x59, 0x61, 0x69, 0x71, 0x79,
+  0x42, 0x4a, 0x52, 0x5a, 0x62, 0x6a, 0x72, 0x7a,
+  0x43, 0x4b, 0x53, 0x5b, 0x63, 0x6b, 0x73, 0x7b,
+  0x44, 0x4c, 0x54, 0x5c, 0x64, 0x6c, 0x74, 0x7c,
+  0x45, 0x4d, 0x55, 0x5d, 0x65, 0x6d, 0x75, 0x7d,
+  0x46, 0x4e, 0x56, 0x5e, 0x66, 0x6e, 0x76, 0x7e,
+  0x47, 0x4f, 0x57, 0x5f, 0x67, 0x6f, 0x77, 0x7f
+};
+
+// Mirror left to right: B<->F, C<->E
+const uint8_t TM1637Font::mirrorSegments[] PROGMEM = {
+  0x00, 0x01, 0x20, 0x21, 0x10, 0x11, 0x30, 0x31,
+  0x08, 0x09, 0x28, 0x29, 0x18, 0x19, 0x38, 0x39,
+  0x04, 0x05, 0x24, 0x25, 0x14, 0x15, 0x34, 0x35,
+  0x0c, 0x0d, 0x2c, 0x2d, 0x1c, 0x1d, 0x3c, 0x3d,
+  0x02, 0x03, 0x22, 0x23, 0x12, 0x13, 0x32, 0x33,
+  0x0a, 0x0b, 0x2a, 0x2b, 0x1a, 0x1b, 0x3a, 0x3b,
+  0x06, 0x07, 0x26, 0x27, 0x16, 0x17, 0x36, 0x37,
+  0x0e, 0x0f, 0x2e, 0x2f, 0x1e, 0x1f, 0x3e, 0x3f,
+  0x40, 0x41, 0x60, 0x61, 0x50, 0x51, 0x70, 0x71,
+  0x48, 0x49, 0x68, 0x69, 0x58, 0x59, 0x78, 0x79,
+  0x44, 0x45, 0x64, 0x65, 0x54, 0x55, 0x74, 0x75,
+  0x4c, 0x4d, 0x6c, 0x6d, 0x5c, 0x5d, 0x7c, 0x7d,
+  0x42, 0x43, 0x62, 0x63, 0x52, 0x53, 0x72, 0x73,
+  0x4a, 0x4b, 0x6a, 0x6b, 0x5a, 0x5b, 0x7a, 0x7b,
+  0x46, 0x47, 0x66, 0x67, 0x56, 0x57, 0x76, 0x77,
+  0x4e, 0x4f, 0x6e, 0x6f, 0x5e, 0x5f, 0x7e, 0x7f
+};
+#endif
+
+#if !TM1637_ENABLE_FULL_FONT
+static const uint8_t degreeSegments = 0b01100011;
+#endif
+
+// Latin-1 letters 0xC0 - 0xFF shown as the letter without accent
+static const char latin1Fold[] PROGMEM =
+  "AAAAAAACEEEEIIIIDNOOOOOxOUUUUYPs"    // 0xC0 - 0xDF
+  "aaaaaaaceeeeiiiidnooooo-ouuuuypy";   // 0xE0 - 0xFF
+
+// Other code points shown as a similar ASCII character (code point high byte,
+// low byte, character), sorted by code point
+static const uint8_t codepointFallback[] PROGMEM = {
+  0x00, 0xA0, ' ',   // U+00A0 No-break space
+  0x00, 0xAD, '-',   // U+00AD Soft hyphen
+  0x00, 0xB2, '2',   // U+00B2 Superscript 2
+  0x00, 0xB3, '3',   // U+00B3 Superscript 3
+  0x00, 0xB5, 'u',   // U+00B5 Micro
+  0x00, 0xB9, '1',   // U+00B9 Superscript 1
+  0x03, 0x91, 'A',   // U+0391 Greek Alpha
+  0x03, 0x92, 'B',   // U+0392 Greek Beta
+  0x03, 0x95, 'E',   // U+0395 Greek Epsilon
+  0x03, 0x96, 'Z',   // U+0396 Greek Zeta
+  0x03, 0x97, 'H',   // U+0397 Greek Eta
+  0x03, 0x99, 'I',   // U+0399 Greek Iota
+  0x03, 0x9A, 'K',   // U+039A Greek Kappa
+  0x03, 0x9D, 'N',   // U+039D Greek Nu
+  0x03, 0x9F, 'O',   // U+039F Greek Omicron
+  0x03, 0xA1, 'P',   // U+03A1 Greek Rho
+  0x03, 0xA4, 'T',   // U+03A4 Greek Tau
+  0x03, 0xA5, 'Y',   // U+03A5 Greek Upsilon
+  0x03, 0xA7, 'X',   // U+03A7 Greek Chi
+  0x03, 0xBC, 'u',   // U+03BC Greek mu
+  0x04, 0x10, 'A',   // U+0410 Cyrillic A
+  0x04, 0x12, 'B',   // U+0412 Cyrillic Ve
+  0x04, 0x15, 'E',   // U+0415 Cyrillic Ie
+  0x04, 0x1A, 'K',   // U+041A Cyrillic Ka
+  0x04, 0x1D, 'H',   // U+041D Cyrillic En
+  0x04, 0x1E, 'O',   // U+041E Cyrillic O
+  0x04, 0x20, 'P',   // U+0420 Cyrillic Er
+  0x04, 0x21, 'C',   // U+0421 Cyrillic Es
+  0x04, 0x22, 'T',   // U+0422 Cyrillic Te
+  0x04, 0x23, 'Y',   // U+0423 Cyrillic U
+  0x04, 0x25, 'X',   // U+0425 Cyrillic Ha
+  0x04, 0x30, 'a',   // U+0430 Cyrillic a
+  0x04, 0x35, 'e',   // U+0435 Cyrillic ie
+  0x04, 0x3E, 'o',   // U+043E Cyrillic o
+  0x04, 0x40, 'p',   // U+0440 Cyrillic er
+  0x04, 0x41, 'c',   // U+0441 Cyrillic es
+  0x04, 0x43, 'y',   // U+0443 Cyrillic u
+  0x04, 0x45, 'x',   // U+0445 Cyrillic ha
+  0x20, 0x10, '-',   // U+2010 Hyphen
+  0x20, 0x11, '-',   // U+2011 Non-breaking hyphen
+  0x20, 0x12, '-',   // U+2012 Figure dash
+  0x20, 0x13, '-',   // U+2013 En dash
+  0x20, 0x14, '-',   // U+2014 Em dash
+  0x20, 0x18, '\'',  // U+2018 Left single quote
+  0x20, 0x19, '\'',  // U+2019 Right single quote
+  0x20, 0x1C, '"',   // U+201C Left double quote
+  0x20, 0x1D, '"',   // U+201D Right double quote
+  0x22, 0x12, '-',   // U+2212 Minus sign
+};
+
+#if TM1637_ENABLE_GLYPHS
+const TM1637Glyphs *TM1637Font::m_glyphs[FONT_GLYPH_TABLES];
+#endif
+
+uint8_t TM1637Font::encodeDigit(uint8_t digit)
+{
+  // 0-9 and A-F (A b C d E F) from the ASCII map
+  digit &= 0x0f;
+  uint8_t chr = digit < 10 ? '0' + digit : 'A' - 10 + digit;
+  return pgm_read_byte(asciiToSegment + (chr - FONT_FIRST_CHAR));
+}
+
+uint8_t TM1637Font::encodeASCII(uint8_t chr)
+{
+#if TM1637_ENABLE_GLYPHS
+  if (m_glyphs[0]) {
+    const TM1637Glyphs *glyphs = findGlyphs(chr);
+    if (glyphs) return pgm_read_byte(glyphs->segments + (chr - glyphs->first) * glyphs->width);
+  }
+#endif
+  return fontSegments(chr);
+}
+
+uint8_t TM1637Font::fontSegments(uint8_t chr)
+{
+#if TM1637_ENABLE_FULL_FONT
+  // Every character has an entry so there is nothing to check
+  return pgm_read_byte(asciiToSegment + chr);
+#else
+  if(chr == FONT_DEGREE) return degreeSegments;   // Degree mark
+  if(chr > 127 || chr < 32) return 0;             // Blank
+  // return asciiToSegment[chr - 32] using PROGMEM
+  return pgm_read_byte(asciiToSegment + (chr - 32));
+#endif
+}
+
+uint8_t TM1637Font::encode(uint16_t codepoint, uint8_t segments[2])
+{
+#if TM1637_ENABLE_GLYPHS
+  if (m_glyphs[0]) {
+    const TM1637Glyphs *glyphs = findGlyphs(codepoint);
+    if (glyphs) {
+      const uint8_t *p = glyphs->segments + (codepoint - glyphs->first) * glyphs->width;
+      segments[0] = pgm_read_byte(p);
+      if (glyphs->width < 2) return 1;
+      segments[1] = pgm_read_byte(p + 1);
+      return 2;
+    }
+  }
+#endif
+  segments[0] = codepointSegments(codepoint);
+  return 1;
+}
+
+// Number of continuation bytes after a UTF-8 lead byte (0 if it is not one)
+static uint8_t utf8Continuations(uint8_t lead)
+{
+  if (lead >= 0xC2 && lead <= 0xDF) return 1;
+  if (lead >= 0xE0 && lead <= 0xEF) return 2;
+  if (lead >= 0xF0 && lead <= 0xF4) return 3;
+  return 0;
+}
+
+uint16_t TM1637Font::decodeUTF8(const char *&s, bool usePROGMEM)
+{
+  uint8_t lead = usePROGMEM ? pgm_read_byte(s) : (uint8_t)*s;
+  if (lead == 0) return 0;
+
+  uint8_t extra = utf8Continuations(lead);
+
+  uint32_t codepoint = extra ? lead & (0x3F >> extra) : lead;
+  for (uint8_t i = 1; i <= extra; i++) {
+    uint8_t c = usePROGMEM ? pgm_read_byte(s + i) : (uint8_t)s[i];
+    if ((c & 0xC0) != 0x80) {
+      // Not UTF-8 - take the lead byte as Latin-1
+      s++;
+      return lead;
+    }
+    codepoint = (codepoint << 6) | (c & 0x3F);
+  }
+  s += extra + 1;
+  return codepoint > 0xFFFF ? FONT_REPLACEMENT : codepoint;
+}
+
+uint8_t TM1637Font::encodeCodepoint(uint16_t codepoint)
+{
+#if TM1637_ENABLE_GLYPHS
+  if (m_glyphs[0]) {
+    const TM1637Glyphs *glyphs = findGlyphs(codepoint);
+    if (glyphs) return pgm_read_byte(glyphs->segments + (codepoint - glyphs->first) * glyphs->width);
+  }
+#endif
+  return codepointSegments(codepoint);
+}
+
+uint8_t TM1637Font::codepointSegments(uint16_t codepoint)
+{
+  if (codepoint < 256) {
+    uint8_t segments = fontSegments(codepoint);
+    if (segments || codepoint < 0xA0) return segments;
+    if (codepoint >= 0xC0) return encodeASCII(pgm_read_byte(latin1Fold + (codepoint - 0xC0)));
+  }
+
+  // Similar ASCII character
+  for (uint8_t i = 0; i < sizeof(codepointFallback); i += 3) {
+    uint16_t key = (pgm_read_byte(codepointFallback + i) << 8) | pgm_read_byte(codepointFallback + i + 1);
+    if (key == codepoint) return encodeASCII(pgm_read_byte(codepointFallback + i + 2));
+    if (key > codepoint) break;
+  }
+  return 0;
+}
+
+#if TM1637_ENABLE_GLYPHS
+bool TM1637Font::addGlyphs(const TM1637Glyphs &glyphs)
+{
+  for (uint8_t i = 0; i < FONT_GLYPH_TABLES; i++) {
+    if (m_glyphs[i] == nullptr) {
+      m_glyphs[i] = &glyphs;
+      return true;
+    }
+  }
+  return false;
+}
+
+void TM1637Font::clearGlyphs()
+{
+  for (uint8_t i = 0; i < FONT_GLYPH_TABLES; i++) m_glyphs[i] = nullptr;
+}
+
+const TM1637Glyphs *TM1637Font::findGlyphs(uint16_t codepoint)
+{
+  // The last table added wins
+  for (uint8_t i = FONT_GLYPH_TABLES; i > 0; i--) {
+    const TM1637Glyphs *glyphs = m_glyphs[i - 1];
+    if (glyphs && (uint16_t)(codepoint - glyphs->first) < glyphs->count) return glyphs;
+  }
+  return nullptr;
+}
+#endif
+
+void TM1637UTF8::reset()
+{
+  m_codepoint = 0;
+  m_lead = 0;
+  m_length = 0;
+  m_remaining = 0;
+}
+
+uint16_t TM1637UTF8::decode(uint8_t b, bool &again)
+{
+  again = false;
+  if (m_remaining) {
+    if ((b & 0xC0) == 0x80) {
+      m_codepoint = (m_codepoint << 6) | (b & 0x3F);
+      if (--m_remaining) return 0;
+      return m_length == 3 ? FONT_REPLACEMENT : m_codepoint;
+    }
+    // Broken sequence - a lone lead byte is Latin-1, a longer part is replaced
+    again = true;
+    uint16_t codepoint = (m_remaining == m_length) ? m_lead : FONT_REPLACEMENT;
+    m_remaining = 0;
+    return codepoint;
+  }
+
+  m_length = utf8Continuations(b);
+  if (m_length == 0) return b;
+  m_lead = b;
+  m_remaining = m_length;
+  m_codepoint = b & (0x3F >> m_length);
+  return 0;
+}
@@ -0,0 +1,171 @@
+//  TM1637 Tiny Display
+//  Font shared by the display classes
+//
+//  Author: Jason A. Cox - @jasonacox - https://github.com/jasonacox
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2.1 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  Custom glyphs (include a display header first):
+//
+//    // Cyrillic capitals А Б В Г Д from the code point U+0410
+//    const uint8_t cyrillicSegments[] PROGMEM = { 0x77, 0x7d, 0x7f, 0x31, 0x5f };
+//    const TM1637Glyphs cyrillic = { 0x410, 5, 1, cyrillicSegments };
+//
+//    // M as two digits (wide glyphs are used by showFormat() and TM1637Print)
+//    const uint8_t wideM[] PROGMEM = { 0x33, 0x27 };
+//    const TM1637Glyphs m = { 'M', 1, 2, wideM };
+//
+//    TM1637Font::addGlyphs(cyrillic);
+//    TM1637Font::addGlyphs(m);
+//
+//  Glyphs are keyed by Unicode code point (below 256 the same as Latin-1) and
+//  match the UTF-8 decoded text, e.g. display.showString("ДА").
+
+#ifndef __TM1637FONT__
+#define __TM1637FONT__
+
+#include <inttypes.h>
+#include "TM1637TinyDisplayConfig.h"
+
+#if TM1637_ENABLE_FULL_FONT
+#define FONT_FIRST_CHAR     0     // asciiToSegment has an entry for every character
+#else
+#define FONT_FIRST_CHAR     32    // asciiToSegment starts at ASCII 32 (Space)
+#endif
+
+#define FONT_DEGREE         176   // Character code of the degree sign
+
+#define FONT_REPLACEMENT    0xFFFD  // Code point returned for characters outside the BMP
+
+#ifndef FONT_GLYPH_TABLES
+#define FONT_GLYPH_TABLES   2     // Custom glyph tables that can be added at once
+#endif
+
+// A range of custom glyphs
+struct TM1637Glyphs {
+  uint16_t first;             // Code point of the first character of the range
+  uint8_t count;              // Number of characters in the range
+  uint8_t width;              // Digits per glyph (1, or 2 for wide glyphs like M and W)
+  const uint8_t *segments;    // PROGMEM segments of the glyphs (count * width bytes)
+};
+
+// Incremental UTF-8 decoder for text that arrives one byte at a time
+class TM1637UTF8 {
+
+public:
+  //! Forget a partly decoded character (call before the first byte)
+  void reset();
+
+  //! Decode the next byte of the text
+  //!
+  //! Like TM1637Font::decodeUTF8() a byte that does not start a valid sequence
+  //! is taken as a Latin-1 character.
+  //!
+  //! @param b The byte
+  //! @param again Set to true if the byte did not continue the character and
+  //!              must be decoded again after the returned character
+  //! @return The code point of a complete character, 0 while more bytes are needed
+  uint16_t decode(uint8_t b, bool &again);
+
+private:
+  uint16_t m_codepoint;
+  uint8_t m_lead;
+  uint8_t m_length;
+  uint8_t m_remaining;
+};
+
+class TM1637Font {
+
+public:
+  //! Translate a number (0-15) to segments, using the ASCII map (0-9, A b C d E F)
+  //!
+  //! @param digit A number between 0 to 15
+  //! @return The segments of the digit (bit 7 - always zero)
+  static uint8_t encodeDigit(uint8_t digit);
+
+  //! Translate a character to segments
+  //!
+  //! Custom glyphs are looked up first (the first digit of a wide glyph is
+  //! returned), then the ASCII map. Characters without a glyph are blank.
+  //!
+  //! @param chr A character code (Latin-1 above 127)
+  //! @return The segments of the character
+  static uint8_t encodeASCII(uint8_t chr);
+
+  //! Translate a Unicode code point to the segments of one or two digits
+  //!
+  //! Custom glyphs can be two digits wide, everything else is encoded like
+  //! encodeCodepoint().
+  //!
+  //! @param codepoint A code point returned by decodeUTF8()
+  //! @param segments Array of two bytes receiving the segments
+  //! @return Number of digits used by the glyph (1 or 2)
+  static uint8_t encode(uint16_t codepoint, uint8_t segments[2]);
+
+  //! Decode the next character of a UTF-8 string
+  //!
+  //! Bytes that do not start a valid UTF-8 sequence are taken as a Latin-1
+  //! character so 8-bit strings (e.g. "\xB0" for the degree sign) still work.
+  //!
+  //! @param s Pointer to the string, advanced past the character
+  //! @param usePROGMEM Indicates if the string is stored in PROGMEM
+  //! @return The code point of the character, 0 at the end of the string
+  static uint16_t decodeUTF8(const char *&s, bool usePROGMEM = false);
+
+  //! Translate a Unicode code point to segments
+  //!
+  //! Custom glyphs are looked up first, code points below 256 use the font.
+  //! Accented Latin-1 letters, Greek and Cyrillic letters that look like Latin
+  //! letters and typographic dashes and quotes fall back to a similar ASCII
+  //! character.
+  //!
+  //! @param codepoint A code point returned by decodeUTF8()
+  //! @return The segments of the character, blank if there is no glyph
+  static uint8_t encodeCodepoint(uint16_t codepoint);
+
+#if TM1637_ENABLE_GLYPHS
+  //! Add a table of custom glyphs used by all displays
+  //!
+  //! Tables added later take precedence. The table is not copied and must stay
+  //! valid while it is used.
+  //!
+  //! @param glyphs The glyph table
+  //! @return false if FONT_GLYPH_TABLES tables are already added
+  static bool addGlyphs(const TM1637Glyphs &glyphs);
+
+  //! Remove all custom glyph tables
+  static void clearGlyphs();
+#endif
+
+  // ASCII to segment map (PROGMEM), index 0 is FONT_FIRST_CHAR
+  static const uint8_t asciiToSegment[];
+
+#if TM1637_ENABLE_FLIP
+  // Orientation maps (PROGMEM) - index is the segment data without decimal point
+  static const uint8_t rotateSegments[];
+  static const uint8_t mirrorSegments[];
+#endif
+
+private:
+  // ASCII map lookup without custom glyphs
+  static uint8_t fontSegments(uint8_t chr);
+
+  // Font and fallbacks of a code point that has no custom glyph
+  static uint8_t codepointSegments(uint16_t codepoint);
+
+#if TM1637_ENABLE_GLYPHS
+  static const TM1637Glyphs *findGlyphs(uint16_t codepoint);
+
+  static const TM1637Glyphs *m_glyphs[FONT_GLYPH_TABLES];
+#endif
+};
+
+#endif // __TM1637FONT__
@@ -0,0 +1,76 @@
+//  TM1637 Tiny Display
+//  Lock-free frame mailbox between a producer and the display
+//
+//  Author: Jason A. Cox - @jasonacox - https://github.com/jasonacox
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2.1 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+
+#include <TM1637FrameMailbox.h>
+#include <Arduino.h>
+
+#define MAILBOX_INDEX   0x03
+#define MAILBOX_NEW     0x04
+
+TM1637FrameMailbox::TM1637FrameMailbox()
+{
+  memset(m_frames, 0, sizeof(m_frames));
+  m_state = 1;
+  m_write = 0;
+  m_read = 2;
+}
+
+uint8_t TM1637FrameMailbox::exchange(uint8_t ready)
+{
+  // Swap the ready frame index in a single atomic step
+#ifdef __AVR__
+  uint8_t sreg = SREG;
+  cli();
+  uint8_t old = m_state;
+  m_state = ready;
+  SREG = sreg;
+  return old;
+#else
+  return __atomic_exchange_n(&m_state, ready, __ATOMIC_ACQ_REL);
+#endif
+}
+
+uint8_t TM1637FrameMailbox::state() const
+{
+#ifdef __AVR__
+  return m_state;
+#else
+  return __atomic_load_n(&m_state, __ATOMIC_ACQUIRE);
+#endif
+}
+
+void TM1637FrameMailbox::post(const uint8_t frame[], uint8_t length)
+{
+  if (length > MAILBOX_DIGITS) length = MAILBOX_DIGITS;
+  memcpy(m_frames[m_write], frame, length);
+  memset(m_frames[m_write] + length, 0, MAILBOX_DIGITS - length);
+
+  // Hand the written frame over and take back the old ready one
+  m_write = exchange(m_write | MAILBOX_NEW) & MAILBOX_INDEX;
+}
+
+const uint8_t *TM1637FrameMailbox::fetch()
+{
+  if (!(state() & MAILBOX_NEW)) return nullptr;
+
+  // Take the ready frame and give back the one read last
+  m_read = exchange(m_read) & MAILBOX_INDEX;
+  return m_frames[m_read];
+}
+
+bool TM1637FrameMailbox::pending() const
+{
+  return state() & MAILBOX_NEW;
+}
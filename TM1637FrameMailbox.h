@@ -0,0 +1,66 @@
+//  TM1637 Tiny Display
+//  Lock-free frame mailbox between a producer and the display
+//
+//  Author: Jason A. Cox - @jasonacox - https://github.com/jasonacox
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2.1 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+
+#ifndef __TM1637FRAMEMAILBOX__
+#define __TM1637FRAMEMAILBOX__
+
+#include <inttypes.h>
+
+// Frame size of the mailbox (large enough for the 6-digit display)
+#define MAILBOX_DIGITS  6
+
+// Triple buffered mailbox for handing complete frames from one producer (a task
+// or an ISR) to the code that drives the display. The producer never waits and
+// the consumer always gets the newest complete frame; older unread frames are
+// dropped. Only the consumer may talk to the display, so the bit-banged bus is
+// never entered twice.
+//
+//   Producer (task or ISR):   mailbox.post(segments);
+//   Consumer (loop):          display.flushMailbox(mailbox);
+class TM1637FrameMailbox {
+
+public:
+  //! Initialize an empty mailbox
+  TM1637FrameMailbox();
+
+  //! Publish a complete frame (producer side, safe in an ISR)
+  //!
+  //! Replaces any frame the consumer has not fetched yet. Must only be called
+  //! from one producer context.
+  //!
+  //! @param frame Array of segment values, one byte per digit
+  //! @param length Number of digits in frame (1 to MAILBOX_DIGITS)
+  void post(const uint8_t frame[], uint8_t length = MAILBOX_DIGITS);
+
+  //! Fetch the newest frame (consumer side)
+  //!
+  //! @return Pointer to the newest frame, valid until the next call to fetch(),
+  //!         or nullptr if nothing was posted since the last fetch
+  const uint8_t *fetch();
+
+  //! Returns true if a frame was posted and not fetched yet
+  bool pending() const;
+
+private:
+  uint8_t exchange(uint8_t ready);
+  uint8_t state() const;
+
+  uint8_t m_frames[3][MAILBOX_DIGITS];
+  volatile uint8_t m_state;   // Index of the ready frame, MAILBOX_NEW if unread
+  uint8_t m_write;            // Frame owned by the producer
+  uint8_t m_read;             // Frame owned by the consumer
+};
+
+#endif // __TM1637FRAMEMAILBOX__
@@ -0,0 +1,122 @@
+//  TM1637 Tiny Display
+//  Compile-time pin binding for fixed wiring
+//
+//  Author: Jason A. Cox - @jasonacox - https://github.com/jasonacox
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2.1 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  Used by the display classes when the library is built with TM1637_CLK_PIN
+//  and TM1637_DIO_PIN (e.g. PlatformIO build_flags = -DTM1637_CLK_PIN=4
+//  -DTM1637_DIO_PIN=5). The pins are template arguments, so the bus functions
+//  are inlined into the display code with constant ports and masks.
+
+#ifndef __TM1637PINS__
+#define __TM1637PINS__
+
+#include <Arduino.h>
+#include "TM1637TinyDisplayConfig.h"
+
+// Pin to port mapping that the compiler can resolve at compile time. With
+// constant pins the DDR registers are in the I/O space, so each line change is
+// a single sbi/cbi instruction and cannot be torn by an interrupt.
+#if defined(__AVR_ATmega328P__) || defined(__AVR_ATmega328__) || \
+    defined(__AVR_ATmega168__) || defined(__AVR_ATmega168P__) || defined(__AVR_ATmega88__)
+// Arduino Uno, Nano and Pro Mini: D0-D7 on PORTD, D8-D13 on PORTB, A0-A5 (14-19) on PORTC
+#define TM1637_PIN_DDR(p)   (*((p) < 8 ? &DDRD : (p) < 14 ? &DDRB : &DDRC))
+#define TM1637_PIN_IN(p)    (*((p) < 8 ? &PIND : (p) < 14 ? &PINB : &PINC))
+#define TM1637_PIN_MASK(p)  ((uint8_t)(1 << ((p) < 8 ? (p) : (p) < 14 ? (p) - 8 : (p) - 14)))
+#elif defined(__AVR_ATtiny25__) || defined(__AVR_ATtiny45__) || defined(__AVR_ATtiny85__)
+// ATtiny85: pins 0-5 are PB0-PB5
+#define TM1637_PIN_DDR(p)   DDRB
+#define TM1637_PIN_IN(p)    PINB
+#define TM1637_PIN_MASK(p)  ((uint8_t)(1 << (p)))
+#endif
+
+template<uint8_t ClkPin, uint8_t DioPin>
+class TM1637Pins {
+
+public:
+  //! Start condition (DIO falls while CLK is high)
+  static inline void start(unsigned int bitDelay)
+  {
+    dioLow();
+    delayMicroseconds(bitDelay);
+  }
+
+  //! Stop condition (DIO rises while CLK is high)
+  static inline void stop(unsigned int bitDelay)
+  {
+    dioLow();
+    delayMicroseconds(bitDelay);
+    clkHigh();
+    delayMicroseconds(bitDelay);
+    dioHigh();
+    delayMicroseconds(bitDelay);
+  }
+
+  //! Write a byte, LSB first, and read the acknowledge
+  static inline bool writeByte(uint8_t b, unsigned int bitDelay)
+  {
+    // 8 Data Bits - unrolled so each bit test and edge is a single instruction
+    writeBit(b & 0x01, bitDelay);
+    writeBit(b & 0x02, bitDelay);
+    writeBit(b & 0x04, bitDelay);
+    writeBit(b & 0x08, bitDelay);
+    writeBit(b & 0x10, bitDelay);
+    writeBit(b & 0x20, bitDelay);
+    writeBit(b & 0x40, bitDelay);
+    writeBit(b & 0x80, bitDelay);
+
+    // Wait for acknowledge
+    clkLow();
+    dioHigh();
+    delayMicroseconds(bitDelay);
+    clkHigh();
+    delayMicroseconds(bitDelay);
+    bool ack = dioRead();
+    if (!ack)
+      dioLow();
+    delayMicroseconds(bitDelay);
+    clkLow();
+    delayMicroseconds(bitDelay);
+
+    return ack;
+  }
+
+private:
+  static inline void writeBit(uint8_t bit, unsigned int bitDelay)
+  {
+    clkLow();
+    delayMicroseconds(bitDelay);
+    if (bit) dioHigh(); else dioLow();
+    delayMicroseconds(bitDelay);
+    clkHigh();
+    delayMicroseconds(bitDelay);
+  }
+
+  // Open drain emulation - OUTPUT (with the port bit low) drives the line low,
+  // INPUT releases it to the pull-up
+#ifdef TM1637_PIN_DDR
+  static inline void clkLow()  { TM1637_PIN_DDR(ClkPin) |= TM1637_PIN_MASK(ClkPin); }
+  static inline void clkHigh() { TM1637_PIN_DDR(ClkPin) &= ~TM1637_PIN_MASK(ClkPin); }
+  static inline void dioLow()  { TM1637_PIN_DDR(DioPin) |= TM1637_PIN_MASK(DioPin); }
+  static inline void dioHigh() { TM1637_PIN_DDR(DioPin) &= ~TM1637_PIN_MASK(DioPin); }
+  static inline bool dioRead() { return TM1637_PIN_IN(DioPin) & TM1637_PIN_MASK(DioPin); }
+#else
+  static inline void clkLow()  { pinMode(ClkPin, OUTPUT); }
+  static inline void clkHigh() { pinMode(ClkPin, INPUT); }
+  static inline void dioLow()  { pinMode(DioPin, OUTPUT); }
+  static inline void dioHigh() { pinMode(DioPin, INPUT); }
+  static inline bool dioRead() { return digitalRead(DioPin); }
+#endif
+};
+
+#endif // __TM1637PINS__
@@ -0,0 +1,218 @@
+//  TM1637 Tiny Display
+//  Arduino Print adapter with a cursor
+//
+//  Author: Jason A. Cox - @jasonacox - https://github.com/jasonacox
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2.1 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  Usage (include the display header first):
+//
+//    #include <TM1637TinyDisplay.h>
+//    #include <TM1637Print.h>
+//
+//    TM1637TinyDisplay display(CLK, DIO);
+//    TM1637Print<TM1637TinyDisplay> lcd(display);
+//
+//    lcd.print(3.5);           // "3.5" - the point is folded into the digit
+//    lcd.println(0xBEEF, HEX); // "BEEF" - the next print starts a new line
+//
+//  Characters are decoded as UTF-8 (like showString(), so "23°C" takes four
+//  digits) and encoded into the frame at the cursor as they are written. The
+//  display is updated at the end of each write (one print() call of a string or
+//  an integer) that changed the line. Text longer than the display scrolls with
+//  the non-blocking scroll engine, so keep calling display.Animate(). Only the
+//  first PRINT_TEXT_LENGTH bytes of a line are kept, the rest is cut from the
+//  scroll.
+
+#ifndef __TM1637PRINT__
+#define __TM1637PRINT__
+
+#include <Arduino.h>
+#include <Print.h>
+#include "TM1637TinyDisplayConfig.h"
+#include "TM1637Font.h"
+
+#ifndef PRINT_TEXT_LENGTH
+#define PRINT_TEXT_LENGTH   32    // Bytes (UTF-8) of a line kept for scrolling
+#endif
+
+template<class Display>
+class TM1637Print : public Print {
+
+public:
+  //! Initialize a Print adapter for a display
+  //!
+  //! @param display The display to print to
+  TM1637Print(Display &display) : m_display(display)
+  {
+#if TM1637_ENABLE_ANIMATION && TM1637_ENABLE_SCROLL
+    m_scrolling = false;
+#endif
+    home();
+    m_dirty = false;
+  }
+
+  using Print::write;
+
+  //! Write a single character and update the display
+  size_t write(uint8_t c)
+  {
+    put(c);
+    flush();
+    return 1;
+  }
+
+  //! Write a buffer of characters and update the display once
+  size_t write(const uint8_t *buffer, size_t size)
+  {
+    for (size_t i = 0; i < size; i++) put(buffer[i]);
+    flush();
+    return size;
+  }
+
+  //! Send the frame to the display
+  //!
+  //! Called at the end of every write, nothing is sent if the line did not
+  //! change. A line longer than the display starts a non-blocking scroll of a
+  //! copy of the line, so printing the next line does not change the scrolling
+  //! text. The scroll shows the first PRINT_TEXT_LENGTH bytes of the line (whole
+  //! characters). Shorter text that runs past the last digit (after setCursor())
+  //! is cut.
+  void flush()
+  {
+    if (!m_dirty) return;
+    m_dirty = false;
+#if TM1637_ENABLE_ANIMATION && TM1637_ENABLE_SCROLL
+    if (m_overflow && m_length > MAXDIGITS) {
+      memcpy(m_scroll, m_text, m_length + 1);
+      m_display.startStringScroll(m_scroll);
+      m_scrolling = true;
+      return;
+    }
+    // Only stop a scroll started here, not animations of the sketch
+    if (m_scrolling) m_display.stopAnimation();
+    m_scrolling = false;
+#endif
+    m_display.setSegments(m_digits);
+  }
+
+  //! Clear the display and move the cursor to the leftmost digit
+  void clear()
+  {
+    home();
+    m_dirty = true;
+    flush();
+  }
+
+  //! Move the cursor to a digit (0 - leftmost)
+  //!
+  //! The following characters overwrite the frame from this digit on.
+  void setCursor(uint8_t pos)
+  {
+    m_newline = false;
+    m_cursor = pos < MAXDIGITS ? pos : MAXDIGITS;
+    m_length = 0;
+    m_text[0] = 0;
+    m_charStart = 0;
+    m_textFull = false;
+    m_overflow = false;
+    m_utf8.reset();
+  }
+
+  //! Returns the digit the next character is written to
+  uint8_t getCursor()
+  {
+    return m_cursor;
+  }
+
+private:
+  void home()
+  {
+    memset(m_digits, 0, sizeof(m_digits));
+    setCursor(0);
+  }
+
+  void put(uint8_t b)
+  {
+    if (b == '\r') return;
+    if (m_newline && b != '\n') home();
+    if (b != '\n') keep(b);
+
+    // Decode UTF-8, a byte that breaks a sequence is decoded again after it
+    bool again = true;
+    while (again) {
+      uint16_t c = m_utf8.decode(b, again);
+      if (c) putChar(c);
+    }
+  }
+
+  // Keep the bytes of the line for scrolling, a character that does not fit
+  // is dropped with all its bytes
+  void keep(uint8_t b)
+  {
+    if (m_textFull) return;
+    if ((b & 0xC0) != 0x80) m_charStart = m_length;
+    if (m_length < PRINT_TEXT_LENGTH) {
+      m_text[m_length++] = b;
+      m_text[m_length] = 0;
+      return;
+    }
+    m_textFull = true;
+    if ((b & 0xC0) == 0x80) {
+      m_length = m_charStart;
+      m_text[m_length] = 0;
+    }
+  }
+
+  void putChar(uint16_t c)
+  {
+    if (c == '\n') {
+      // End of line - show it (once) and start over with the next character
+      flush();
+      m_newline = true;
+      return;
+    }
+    m_dirty = true;
+
+    if (c == '.' && m_cursor > 0 && m_cursor <= MAXDIGITS && !(m_digits[m_cursor - 1] & 0b10000000)) {
+      // Fold the point into the previous digit
+      m_digits[m_cursor - 1] |= 0b10000000;
+      return;
+    }
+    // A wide glyph takes two digits
+    uint8_t glyph[2];
+    uint8_t width = TM1637Font::encode(c, glyph);
+    if (m_cursor + width <= MAXDIGITS) {
+      for (uint8_t i = 0; i < width; i++) m_digits[m_cursor++] = glyph[i];
+    }
+    else {
+      m_overflow = true;
+    }
+  }
+
+  Display &m_display;
+  char m_text[PRINT_TEXT_LENGTH + 1];
+  TM1637UTF8 m_utf8;
+#if TM1637_ENABLE_ANIMATION && TM1637_ENABLE_SCROLL
+  char m_scroll[PRINT_TEXT_LENGTH + 1];   // Line being scrolled by the display
+  bool m_scrolling;
+#endif
+  uint8_t m_digits[MAXDIGITS];
+  uint8_t m_cursor;
+  uint8_t m_length;
+  uint8_t m_charStart;        // Start of the last character in m_text
+  bool m_textFull;
+  bool m_overflow;
+  bool m_newline;
+  bool m_dirty;               // Line changed since the last flush()
+};
+
+#endif // __TM1637PRINT__
@@ -0,0 +1,141 @@
+//  TM1637 Tiny Display
+//  Pictures of display frames as ASCII art and raw images
+//
+//  Author: Jason A. Cox - @jasonacox - https://github.com/jasonacox
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2.1 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+
+#include <TM1637Render.h>
+#include <Arduino.h>
+#ifdef __AVR__
+#include <avr/pgmspace.h>
+#elif defined(ESP8266) || defined(ESP32)
+#include <pgmspace.h>
+#elif !defined(pgm_read_byte)
+#define pgm_read_byte(addr)                                                    \
+  (*(const unsigned char *)(addr)) // workaround for non-AVR
+#endif
+
+const uint8_t TM1637Render::addressOrder6[6] = { 2, 1, 0, 5, 4, 3 };
+
+// Grey levels of the PGM image
+#define RENDER_BACKGROUND     0
+#define RENDER_DARK           24    // Segment that is not lit
+#define RENDER_LIT_MIN        80    // Lit segment at brightness 0
+#define RENDER_LIT_STEP       25    // Added for each brightness step (7 - 255)
+
+//
+//      A
+//     ---
+//  F |   | B
+//     -G-
+//  E |   | C
+//     ---
+//      D     . DP
+// Rectangle of each segment in a digit cell (x0, y0, x1, y1 - inclusive)
+static const uint8_t segmentRects[8][4] PROGMEM = {
+  {  2,  0,  7,  1 },   // A
+  {  8,  2,  9,  8 },   // B
+  {  8, 11,  9, 17 },   // C
+  {  2, 18,  7, 19 },   // D
+  {  0, 11,  1, 17 },   // E
+  {  0,  2,  1,  8 },   // F
+  {  2,  9,  7, 10 },   // G
+  { 11, 18, 12, 19 },   // DP
+};
+
+uint8_t TM1637Render::segments(const uint8_t frame[], uint8_t digit, uint8_t brightness,
+  const uint8_t *order)
+{
+  if (!(brightness & 0x08)) return 0;
+  return frame[order ? order[digit] : digit];
+}
+
+size_t TM1637Render::print(Print &out, const uint8_t frame[], uint8_t digits,
+  uint8_t brightness, const uint8_t *order)
+{
+  size_t n = 0;
+  for (uint8_t row = 0; row < 3; row++) {
+    for (uint8_t k = 0; k < digits; k++) {
+      uint8_t seg = segments(frame, k, brightness, order);
+      char cell[5] = "    ";
+      if (row == 0) {
+        if (seg & 0b00000001) cell[1] = '_';
+      }
+      else if (row == 1) {
+        if (seg & 0b00100000) cell[0] = '|';
+        if (seg & 0b01000000) cell[1] = '_';
+        if (seg & 0b00000010) cell[2] = '|';
+      }
+      else {
+        if (seg & 0b00010000) cell[0] = '|';
+        if (seg & 0b00001000) cell[1] = '_';
+        if (seg & 0b00000100) cell[2] = '|';
+        if (seg & 0b10000000) cell[3] = '.';
+      }
+      n += out.print(cell);
+    }
+    n += out.print("\r\n");
+  }
+  return n;
+}
+
+size_t TM1637Render::printPGM(Print &out, const uint8_t frame[], uint8_t digits,
+  uint8_t brightness, uint8_t scale, const uint8_t *order)
+{
+  if (scale == 0) scale = 1;
+  unsigned int width = (unsigned int)digits * RENDER_DIGIT_WIDTH * scale;
+  unsigned int height = RENDER_DIGIT_HEIGHT * scale;
+  uint8_t lit = RENDER_LIT_MIN + RENDER_LIT_STEP * (brightness & 0x07);
+
+  size_t n = 0;
+  n += out.print("P5\n");
+  n += out.print(width);
+  n += out.print(" ");
+  n += out.print(height);
+  n += out.print("\n255\n");
+
+  for (unsigned int y = 0; y < height; y++) {
+    uint8_t cy = y / scale;
+    for (unsigned int x = 0; x < width; x++) {
+      uint8_t digit = x / (RENDER_DIGIT_WIDTH * scale);
+      uint8_t cx = (x / scale) % RENDER_DIGIT_WIDTH;
+      uint8_t seg = segments(frame, digit, brightness, order);
+      uint8_t pixel = RENDER_BACKGROUND;
+      for (uint8_t s = 0; s < 8; s++) {
+        if (cx >= pgm_read_byte(&segmentRects[s][0]) && cy >= pgm_read_byte(&segmentRects[s][1]) &&
+            cx <= pgm_read_byte(&segmentRects[s][2]) && cy <= pgm_read_byte(&segmentRects[s][3])) {
+          pixel = (seg & (1 << s)) ? lit : RENDER_DARK;
+          break;
+        }
+      }
+      n += out.write(pixel);
+    }
+  }
+  return n;
+}
+
+#if TM1637_ENABLE_CAPTURE
+size_t TM1637Render::print(Print &out, const TM1637Capture &capture)
+{
+  size_t n = 0;
+  for (unsigned int i = 0; i < capture.count(); i++) {
+    const TM1637CaptureEntry &e = capture.entry(i);
+    n += out.print("Frame ");
+    n += out.print(i);
+    n += out.print(" - ");
+    n += out.print(e.ms - capture.entry(0).ms);
+    n += out.print(" ms\r\n");
+    n += print(out, e.frame, capture.digits(), e.brightness);
+  }
+  return n;
+}
+#endif
@@ -0,0 +1,98 @@
+//  TM1637 Tiny Display
+//  Pictures of display frames as ASCII art and raw images
+//
+//  Author: Jason A. Cox - @jasonacox - https://github.com/jasonacox
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2.1 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  Usage:
+//
+//    uint8_t frame[4];
+//    display.showNumber(8234);
+//    display.readBuffer(frame);
+//    TM1637Render::print(Serial, frame, 4);
+//
+//     _   _   _
+//    |_|  _|  _| |_|
+//    |_| |_   _|   |
+//
+//  The output is plain text (or a binary PGM image with printPGM()), so the
+//  same frames give the same bytes on a board and on a host build and can be
+//  compared against stored pictures.
+
+#ifndef __TM1637RENDER__
+#define __TM1637RENDER__
+
+#include <inttypes.h>
+#include <stddef.h>
+#include "TM1637TinyDisplayConfig.h"
+#include "TM1637Capture.h"
+
+// Size of one digit in a PGM image at scale 1 (including the gap to the next digit)
+#define RENDER_DIGIT_WIDTH    14
+#define RENDER_DIGIT_HEIGHT   20
+
+class Print;
+
+// Renders segment frames the way the display shows them. Frames are in digit
+// order (leftmost digit first) like readBuffer() and TM1637Capture. A copy of
+// the chip's display RAM is rendered with an address order, e.g. addressOrder6
+// for the 6-digit module whose leftmost digit is at address 2.
+class TM1637Render {
+
+public:
+  //! Write a frame as three lines of ASCII art
+  //!
+  //! A display that is switched off (bit 3 of brightness clear) is drawn blank.
+  //!
+  //! @param out Where to write the picture (e.g. Serial)
+  //! @param frame Array of segment values
+  //! @param digits Number of digits to draw
+  //! @param brightness Brightness (bits 0-2) and on (bit 3) of the display
+  //! @param order Index into frame of each digit from the left (nullptr - digit order)
+  //! @return Number of characters written
+  static size_t print(Print &out, const uint8_t frame[], uint8_t digits,
+    uint8_t brightness = 0x0f, const uint8_t *order = nullptr);
+
+  //! Write a frame as a binary PGM (P5) image
+  //!
+  //! Lit segments are drawn at a grey level that follows the brightness, dark
+  //! segments are drawn faintly so the digits stay visible. The image is
+  //! digits * RENDER_DIGIT_WIDTH by RENDER_DIGIT_HEIGHT pixels times scale.
+  //!
+  //! @param out Where to write the image (e.g. a file on a host build)
+  //! @param frame Array of segment values
+  //! @param digits Number of digits to draw
+  //! @param brightness Brightness (bits 0-2) and on (bit 3) of the display
+  //! @param scale Pixels per image unit (1 or more)
+  //! @param order Index into frame of each digit from the left (nullptr - digit order)
+  //! @return Number of bytes written
+  static size_t printPGM(Print &out, const uint8_t frame[], uint8_t digits,
+    uint8_t brightness = 0x0f, uint8_t scale = 1, const uint8_t *order = nullptr);
+
+#if TM1637_ENABLE_CAPTURE
+  //! Write every entry of a capture as ASCII art with its time
+  //!
+  //! @param out Where to write the pictures (e.g. Serial)
+  //! @param capture The recorded frames
+  //! @return Number of characters written
+  static size_t print(Print &out, const TM1637Capture &capture);
+#endif
+
+  // Display RAM address of each digit of the 6-digit module, from the left
+  static const uint8_t addressOrder6[6];
+
+private:
+  static uint8_t segments(const uint8_t frame[], uint8_t digit, uint8_t brightness,
+    const uint8_t *order);
+};
+
+#endif // __TM1637RENDER__
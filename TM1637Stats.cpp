@@ -0,0 +1,55 @@
+//  TM1637 Tiny Display
+//  Optional timing statistics of the display functions
+//
+//  Author: Jason A. Cox - @jasonacox - https://github.com/jasonacox
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2.1 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+
+#include <TM1637Stats.h>
+
+#if TM1637_ENABLE_STATS
+
+#include <Arduino.h>
+
+TM1637StatsTimer::TM1637StatsTimer(TM1637Stats &stats, uint8_t function)
+  : m_stats(stats), m_start(micros()), m_function(function)
+{
+}
+
+TM1637StatsTimer::~TM1637StatsTimer()
+{
+  unsigned long us = micros() - m_start;
+
+  m_stats.calls[m_function]++;
+  m_stats.totalUs[m_function] += us;
+  if (us > m_stats.maxUs[m_function]) m_stats.maxUs[m_function] = us;
+
+  // Bucket is the number of significant bits of the duration
+  uint8_t bucket = 0;
+  while (us && bucket < STATS_BUCKETS - 1) {
+    us >>= 1;
+    bucket++;
+  }
+  if (m_stats.histogram[bucket] < 0xFFFF) m_stats.histogram[bucket]++;
+}
+
+unsigned long TM1637Stats::estimateUs(const TM1637CostTable &costs) const
+{
+  if (costs.mhz == 0) return delayUs;
+
+  uint64_t cycles = (uint64_t)pinAccesses * costs.pinAccess
+                  + (uint64_t)bitDelays * costs.bitDelay
+                  + (uint64_t)divides * costs.divide
+                  + (uint64_t)progmemReads * costs.progmemRead;
+  return (unsigned long)(cycles / costs.mhz) + delayUs;
+}
+
+#endif // TM1637_ENABLE_STATS
@@ -0,0 +1,85 @@
+//  TM1637 Tiny Display
+//  Optional timing statistics of the display functions
+//
+//  Author: Jason A. Cox - @jasonacox - https://github.com/jasonacox
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2.1 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+
+#ifndef __TM1637STATS__
+#define __TM1637STATS__
+
+#include <inttypes.h>
+#include "TM1637TinyDisplayConfig.h"
+
+#if TM1637_ENABLE_STATS
+
+// Timed functions (index into the TM1637Stats arrays)
+#define STATS_WRITEBUFFER   0
+#define STATS_BRIGHTNESS    1
+#define STATS_ANIMATE       2
+#define STATS_FUNCTIONS     3
+
+// Histogram buckets - bucket n counts calls taking 2^(n-1) to 2^n - 1 microseconds
+// (bucket 0 is under 1us, the last bucket also holds everything longer)
+#define STATS_BUCKETS       16
+
+// CPU cycles of one counted operation on the target, measured by the caller
+// (e.g. by timing a loop of digitalRead() or pgm_read_byte()) - no defaults are
+// built in as they depend on the core, compiler and clock
+struct TM1637CostTable {
+  uint16_t pinAccess;                       // Cycles of one pinMode() or digitalRead()
+  uint16_t bitDelay;                        // Cycles of one bit delay call, excluding the delay itself
+  uint16_t divide;                          // Cycles of one integer divide or modulo
+  uint16_t progmemRead;                     // Cycles of one PROGMEM byte read
+  uint8_t mhz;                              // CPU clock in MHz
+};
+
+struct TM1637Stats {
+  unsigned long transactions;               // Bus transactions (start to stop)
+  unsigned long bytes;                      // Bytes written with writeByte()
+  unsigned long calls[STATS_FUNCTIONS];     // Calls of writeBuffer(), setBrightness(), Animate()
+                                            // (frame writes of setFrame() and writeChanged() count as writeBuffer())
+  unsigned long totalUs[STATS_FUNCTIONS];   // Microseconds blocked in each function
+  unsigned long maxUs[STATS_FUNCTIONS];     // Longest call of each function
+  uint16_t histogram[STATS_BUCKETS];        // log2 latency histogram of all timed calls
+  unsigned long pinAccesses;                // pinMode() and digitalRead() calls of the bit-banged bus
+  unsigned long bitDelays;                  // Bit delays (bit-banged bus and waveform line states)
+  unsigned long delayUs;                    // Microseconds requested by the bit delays
+  unsigned long divides;                    // Integer divide and modulo operations of the drawing functions
+  unsigned long progmemReads;               // Bytes read from PROGMEM (font, orientation and animation tables, _P strings)
+
+  // Estimated microseconds of the counted work for a target described by costs
+  unsigned long estimateUs(const TM1637CostTable &costs) const;
+};
+
+// Adds n to a counter of m_stats
+#define STATS_COUNT(counter, n) (m_stats.counter += (n))
+
+// Times a function from construction to the end of its scope
+class TM1637StatsTimer {
+
+public:
+  TM1637StatsTimer(TM1637Stats &stats, uint8_t function);
+  ~TM1637StatsTimer();
+
+private:
+  TM1637Stats &m_stats;
+  unsigned long m_start;
+  uint8_t m_function;
+};
+
+#else
+
+#define STATS_COUNT(counter, n) ((void)0)
+
+#endif // TM1637_ENABLE_STATS
+
+#endif // __TM1637STATS__
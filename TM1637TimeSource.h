@@ -0,0 +1,37 @@
+//  TM1637 Tiny Display
+//  Time source used for animations and delays
+//
+//  Author: Jason A. Cox - @jasonacox - https://github.com/jasonacox
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2.1 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+
+#ifndef __TM1637TIMESOURCE__
+#define __TM1637TIMESOURCE__
+
+#include <stdint.h>
+
+// Clock functions used by a display in place of millis() and delay(), e.g. a
+// virtual clock that a test fast-forwards instead of waiting. Time stamps are
+// 32 bit on every platform (also where unsigned long is 64 bit) and elapsed
+// times are computed as unsigned differences, so the clock may wrap at 2^32.
+//
+//   uint32_t virtualMs = 0;
+//   uint32_t virtualNow() { return virtualMs; }
+//   void virtualWait(uint32_t ms) { virtualMs += ms; }
+//   const TM1637TimeSource virtualClock = { virtualNow, virtualWait };
+//
+//   display.setTimeSource(&virtualClock);
+struct TM1637TimeSource {
+  uint32_t (*now)();                  // Milliseconds since an arbitrary start
+  void (*wait)(uint32_t ms);          // Block for a number of milliseconds
+};
+
+#endif // __TM1637TIMESOURCE__
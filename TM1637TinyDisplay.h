@@ -25,6 +25,17 @@
 
 // Include PROGMEM Support
 #include <inttypes.h>
+#include <stdarg.h>
+#include "TM1637TinyDisplayConfig.h"
+#include "TM1637Waveform.h"
+#include "TM1637USI.h"
+#include "TM1637FrameMailbox.h"
+#include "TM1637Stats.h"
+#include "TM1637Capture.h"
+#include "TM1637TimeSource.h"
+#include "TM1637Font.h"
+class Stream;
+
 #ifdef __AVR__
 #include <avr/pgmspace.h>
 #elif defined(ESP8266) || defined(ESP32)
@@ -103,6 +114,7 @@
 #define TM1637_I2C_COMM1    0x40  // CmdSetData       0b01000000
 #define TM1637_I2C_COMM2    0xC0  // CmdSetAddress    0b11000000
 #define TM1637_I2C_COMM3    0x80  // CmdDisplay       0b10000000
+#define TM1637_FIXED_ADDR   0x04  // CmdSetData fixed address mode
 
 #define MAXDIGITS           4     // Total number of digits   
 
@@ -110,6 +122,39 @@
 #define DEFAULT_SCROLL_DELAY  100
 #define DEFAULT_FLIP          false
 
+// Display orientation - see setOrientation()
+#define ORIENTATION_NORMAL    0x00  // Normal
+#define ORIENTATION_MIRROR    0x01  // Mirrored left to right (e.g. viewed in a reflection)
+#define ORIENTATION_MIRROR_V  0x02  // Mirrored top to bottom (e.g. head-up display)
+#define ORIENTATION_FLIP      0x03  // Rotated 180 degrees (upside down)
+#define DEFAULT_BLINK_DELAY   500
+#define FORMAT_MAX_PRECISION  6     // Most decimals of a showFormat() %f
+
+#define SCROLL_UNKNOWN_FRAMES 0xFFFF      // Frame count of a scroll until the end of the text is found
+#define SCROLL_REBASE_FRAMES  0x4000      // Frames after which an endless scroll restarts its frame count
+#define SCROLL_WAIT           0xFFFF      // scrollChar() result when the source has no character yet
+
+// Scroll source results
+#define SOURCE_END            -1          // End of the text
+#define SOURCE_WAIT           -2          // No character available yet
+#define NO_DEADLINE           0xFFFFFFFF  // Returned by nextDeadlineMs() when idle
+
+// Countdown/stopwatch states
+#define TIMER_STOPPED         0
+#define TIMER_RUNNING         1
+#define TIMER_PAUSED          2
+
+// Level meter modes
+#define METER_BAR             0x00  // Vertical bars from left to right (2 per digit)
+#define METER_STACK           0x01  // Horizontal lines from the bottom up (3 per digit)
+#define METER_PEAK            0x02  // Show a peak-hold marker
+#define METER_CENTER          0x04  // Centre-zero bars for negative and positive samples
+#define METER_ACTIVE          0x80  // Set while the meter engine is running
+
+// Transport used to send bytes to the display
+#define TRANSPORT_BITBANG     0   // Bit-banged on any two GPIO pins
+#define TRANSPORT_USI         1   // USI peripheral on ATtiny (CLK on SCL, DIO on SDA)
+
 #define FRAMES(a)     sizeof(a)/4
 #define TIME_MS(t)    t
 #define TIME_S(t)     t*1000
@@ -124,8 +169,12 @@ public:
   //! @param bitDelay - The delay, in microseconds, between bit transition on the serial
   //!                   bus connected to the display
   //! @param flip - Flip display orientation (default=false)
+  //! @param transport - TRANSPORT_BITBANG (default) or TRANSPORT_USI to shift the bytes
+  //!                    with the USI peripheral. Falls back to bit-banging in begin() if
+  //!                    the pins are not the USI pins or the controller has no USI.
   TM1637TinyDisplay(uint8_t pinClk, uint8_t pinDIO, unsigned int bitDelay = DEFAULT_BIT_DELAY, 
-    unsigned int scrollDelay = DEFAULT_SCROLL_DELAY, bool flip=DEFAULT_FLIP);
+    unsigned int scrollDelay = DEFAULT_SCROLL_DELAY, bool flip=DEFAULT_FLIP,
+    uint8_t transport=TRANSPORT_BITBANG);
 
   //! Initialize the display, setting the clock and data pins.
   //!
@@ -134,6 +183,26 @@ public:
   //! @param clearDisplay - Clear display and set the brightness to maximum value.
   void begin(bool clearDisplay=true);
 
+  //! Initialize the display and show a first frame in one short burst
+  //!
+  //! Sets up the pins like begin(false) and sends the data command, the frame and
+  //! the display control (brightness and on) back to back, three transactions in
+  //! total instead of the five of begin() followed by a show call. Use it for a
+  //! boot code that must appear within a few milliseconds of reset.
+  //! The _P function is for reading PROGMEM read-only flash memory space instead of RAM
+  //!
+  //! @param frame An array of MAXDIGITS raw segment values (leftmost digit first)
+  //! @param brightness A number from 0 (lowest brightness) to 7 (highest brightness)
+  //! @param initBitDelay Bit delay in microseconds for this burst only (0 - the delay
+  //!                     of the display). Short wires with stiff pull-ups allow a few
+  //!                     microseconds.
+  //! @param usePROGMEM Indicates if the frame is stored in PROGMEM
+  void beginFrame(const uint8_t frame[], uint8_t brightness = BRIGHT_HIGH,
+    unsigned int initBitDelay = 0, bool usePROGMEM = false);
+  void beginFrame_P(const uint8_t frame[], uint8_t brightness = BRIGHT_HIGH,
+    unsigned int initBitDelay = 0);
+
+#if TM1637_ENABLE_FLIP
   //! Sets the orientation of the display.
   //!
   //! Setting this parameter to true will cause the rendering on digits to be displayed
@@ -148,6 +217,21 @@ public:
   //!
   bool isflipDisplay();
 
+  //! Sets the orientation of the display, including mirrored modes.
+  //!
+  //! The oriented frame is computed once from lookup tables whenever the content
+  //! changes, so writing the display costs the same in every orientation.
+  //!
+  //! @param orientation One of ORIENTATION_NORMAL, ORIENTATION_FLIP (upside down),
+  //!        ORIENTATION_MIRROR (left to right) or ORIENTATION_MIRROR_V (top to bottom)
+  void setOrientation(uint8_t orientation);
+
+  //! Returns the orientation of the display (ORIENTATION_NORMAL, ORIENTATION_FLIP,
+  //! ORIENTATION_MIRROR or ORIENTATION_MIRROR_V)
+  //!
+  uint8_t getOrientation();
+#endif
+
   //! Sets the brightness of the display.
   //!
   //! The setting takes effect when a command is given to change the data being
@@ -157,6 +241,7 @@ public:
   //! @param on Turn display on or off
   void setBrightness(uint8_t brightness, bool on = true);
 
+#if TM1637_ENABLE_SCROLL
   //! Sets the delay used to scroll string text (in ms).
   //!
   //! The setting takes effect when a showString() command send an argument with over
@@ -164,6 +249,7 @@ public:
   //!
   //! @param scrollDelay A number in milliseconds (default is 200)
   void setScrolldelay(unsigned int scrollDelay = 200);
+#endif
 
   //! Write the digitsbuf[] to the Display
   //!
@@ -172,6 +258,112 @@ public:
   //!
   void writeBuffer();
 
+  //! Compile the display update into a bus waveform
+  //!
+  //! The waveform holds the complete refresh of the display (data command, all
+  //! digits and the brightness command) as precompiled line states. It can be
+  //! replayed with playWaveform() or inspected with TM1637Waveform::decode().
+  //!
+  //! @param wave The waveform to fill (previous content is cleared)
+  //! @return false if the waveform was too small for the update
+  bool compileBuffer(TM1637Waveform &wave);
+
+  //! Replay a precompiled waveform on the display pins
+  //!
+  //! @param wave The waveform to send, at the bit delay of the display
+  void playWaveform(const TM1637Waveform &wave);
+
+#if TM1637_ENABLE_STATS
+  //! Returns a copy of the timing statistics
+  //!
+  //! Counts bus transactions and bytes, and times writeBuffer(), setBrightness() and
+  //! Animate() (calls, total and longest time blocked, log2 histogram of all calls).
+  TM1637Stats getStats();
+
+  //! Reset the timing statistics
+  void resetStats();
+#endif
+
+#if TM1637_ENABLE_CAPTURE
+  //! Record everything sent to the display
+  //!
+  //! Every frame update (full or partial) and brightness change is logged with
+  //! its time stamp into the capture, which can then be exported in the format
+  //! of the animator with TM1637Capture::print().
+  //!
+  //! @param capture The capture to record into (nullptr stops recording)
+  void setCapture(TM1637Capture *capture);
+#endif
+
+#if TM1637_ENABLE_TIME_SOURCE
+  //! Take time from a time source instead of millis() and delay()
+  //!
+  //! All animation, blink, scroll, timer and meter timing and the blocking
+  //! delays of showString() and showAnimation() use the time source.
+  //!
+  //! @param source The clock functions (nullptr - millis() and delay())
+  void setTimeSource(const TM1637TimeSource *source);
+#endif
+
+  //! Display state captured by saveState()
+  //!
+  //! A plain struct that can be kept anywhere (e.g. a global or on the stack)
+  //! while an overlay is shown.
+  struct State {
+#if TM1637_ENABLE_ANIMATION
+    unsigned long animationElapsed;   // Time into the animation or scroll
+    unsigned long blinkElapsed;       // Time into the blink period
+    union {
+      uint8_t (*animationSequence)[MAXDIGITS];
+#if TM1637_ENABLE_SCROLL
+      uint8_t *animationString;
+      int (*scrollSource)(void *context);
+#endif
+    };
+#if TM1637_ENABLE_SCROLL
+    union {
+      const char *scrollNext;
+      void *scrollContext;
+    };
+#endif
+    unsigned int animationFrames;
+    unsigned int animationLastFrame;
+    unsigned int animationFrameMs;
+    unsigned int blinkMs;
+#if TM1637_ENABLE_SCROLL
+    int scrollPeek;
+    TM1637UTF8 scrollDecoder;
+#endif
+    uint8_t animationType;
+    uint8_t blinkDigits;
+    uint8_t blinkDots;
+    uint8_t blinkPhase;
+    uint8_t blinkState;
+#endif
+    uint8_t digits[MAXDIGITS];
+    uint8_t brightness;
+#if TM1637_ENABLE_FLIP
+    uint8_t orientation;
+#endif
+  };
+
+  //! Capture the digits, brightness, orientation and the running animation,
+  //! scroll and blink of the display
+  //!
+  //! The countdown/stopwatch, level meter and clock are not part of the state.
+  //!
+  //! @return The state, to be passed to restoreState()
+  State saveState();
+
+  //! Restore a state captured by saveState()
+  //!
+  //! The digits are sent with a single update (plus a brightness command if the
+  //! brightness changed) and an animation or scroll continues from the frame it
+  //! was at when the state was saved, without decoding the text again.
+  //!
+  //! @param state The state returned by saveState()
+  void restoreState(const State &state);
+
   //! Create and return a copy the digitsbuf[] in buffercopy
   //!
   //! This copies the buffer of segment settings into the memory location provided.
@@ -204,6 +396,31 @@ public:
   //! @param pos The position from which to start the modification (0 - leftmost, 3 - rightmost)
   void setSegments(const uint8_t A, uint8_t pos = 0);
 
+  //! Display a complete pre-encoded frame
+  //!
+  //! This function receives MAXDIGITS raw segment values (leftmost digit first) and sends
+  //! them to the display directly from the caller's buffer, without first copying them
+  //! into an intermediate buffer. The stored display state is updated as the bytes are
+  //! sent, and nothing is sent if the frame matches what is already displayed (call
+  //! writeBuffer() to force a refresh). The first frame after begin() is always sent,
+  //! as the display RAM content is undefined at power-on. Flipped/mirrored orientations,
+  //! blinking digits and waveform builds fall back to the regular setSegments() path.
+  //! The _P function is for reading PROGMEM read-only flash memory space instead of RAM
+  //!
+  //! @param frame An array of MAXDIGITS raw segment values
+  //! @param usePROGMEM Indicates if the frame is stored in PROGMEM
+  void setFrame(const uint8_t frame[], bool usePROGMEM = false);
+  void setFrame_P(const uint8_t frame[]);
+
+  //! Display the newest frame posted to a mailbox
+  //!
+  //! Call this regularly from the one context that drives the display (e.g. loop())
+  //! while other tasks or ISRs post frames with TM1637FrameMailbox::post().
+  //!
+  //! @param mailbox The mailbox to read
+  //! @return true if a new frame was taken from the mailbox
+  bool flushMailbox(TM1637FrameMailbox &mailbox);
+
   //! Clear the display
   void clear();
 
@@ -233,6 +450,7 @@ public:
   //! @param pos The position of the most significant digit (0 - leftmost, 3 - rightmost)
   void showNumber(long num, bool leading_zero = false, uint8_t length = MAXDIGITS, uint8_t pos = 0);
 
+#if TM1637_ENABLE_FLOAT
   //! Display a decimal number with floating point
   //!
   //! Display the given argument as a decimal number. Decimal point will only show up on displays
@@ -246,6 +464,7 @@ public:
   //!        the number must be between 0 to 99)
   //! @param pos The position of the most significant digit (0 - leftmost, 3 - rightmost)
   void showNumber(double num, uint8_t decimal_length = MAXDIGITS, uint8_t length = MAXDIGITS, uint8_t pos = 0);
+#endif
 
   //! Display a decimal number, with dot control
   //!
@@ -314,7 +533,7 @@ public:
   //!
   //! Display the given string and if more than 4 characters, will scroll message on display
   //!
-  //! @param s The string to be shown
+  //! @param s The string to be shown (UTF-8, e.g. "23°C")
   //! @param scrollDelay  The delay, in microseconds to wait before scrolling to next frame
   //! @param length The number of digits to set. 
   //! @param pos The position of the most significant digit (0 - leftmost, 3 - rightmost)
@@ -338,7 +557,7 @@ public:
   //! Display the given string and if more than 4 characters, will scroll message on display
   //! This function is for reading PROGMEM read-only flash memory space instead of RAM
   //!
-  //! @param s The string to be shown
+  //! @param s The string to be shown (UTF-8, e.g. "23°C")
   //! @param scrollDelay  The delay, in microseconds to wait before scrolling to next frame
   //! @param length The number of digits to set. 
   //! @param pos The position of the most significant digit (0 - leftmost, 3 - rightmost)
@@ -357,6 +576,46 @@ public:
   //! This function is for reading PROGMEM read-only flash memory space instead of RAM
   void showString_P(const char s[], uint8_t length = MAXDIGITS, uint8_t pos = 0, uint8_t dots = 0);
 
+  //! Display formatted text
+  //!
+  //! A small printf subset that renders straight to segments without stdio:
+  //!   %d %i %u %x (a-f) %X (A-F) (l prefix for long), %f (fixed decimals, default 2, at most
+  //!   FORMAT_MAX_PRECISION), %c, %s, %%
+  //!   flags '-' (left align), '0' (zero pad), '+' and ' ' (sign), width and precision
+  //! A '.' or ':' in the output sets the decimal point of the previous digit (the
+  //! colon on clock displays) and does not count towards the width. The format
+  //! and %s strings are decoded as UTF-8 like showString() (e.g. the degree sign).
+  //! Output longer than the display is cut.
+  //! i.e. showFormat("%2d:%02d", m, s) or showFormat("%d\xB0" "C", t)
+  //! The _P function is for reading PROGMEM read-only flash memory space instead of RAM
+  //!
+  //! @param fmt The format string
+  void showFormat(const char fmt[], ...);
+  void showFormat_P(const char fmt[], ...);
+
+#if TM1637_ENABLE_CLOCK
+  //! Display a time of day
+  //!
+  //! Shows hh:mm on the 4-digit display (hh.mm.ss on the 6-digit display) with
+  //! leading zeros. Only the digits that changed since the last update are sent.
+  //! The colon is not timer driven: with blinkColon it is set from the seconds of
+  //! each update, so it only blinks when the time is updated every second.
+  //!
+  //! @param hours Hours (0 - 23)
+  //! @param minutes Minutes (0 - 59)
+  //! @param seconds Seconds (0 - 59), selects whether the colon is lit
+  //! @param blinkColon Light the colon on even seconds only (true) or always (false)
+  void showTime(uint8_t hours, uint8_t minutes, uint8_t seconds = 0, bool blinkColon = true);
+
+  //! Advance the time shown by showTime()
+  //!
+  //! Carries into minutes and hours (wrapping after 23:59:59) and sends only
+  //! the changed digits. Call once per second for a clock.
+  //!
+  //! @param seconds Number of seconds to advance
+  void tickTime(unsigned int seconds = 1);
+#endif
+
   //! Display a Level Indicator (both orientations)
   //!
   //! Illuminate LEDs to provide a visual indicator of level (horizontal or vertical orientation)
@@ -364,6 +623,44 @@ public:
   //! @param level A value between 0 and 100 (representing percentage)
   //! @param horizontal Boolean (true/false) where true = horizontal, false = vertical
   void showLevel(unsigned int level = 100, bool horizontal = true);
+
+#if TM1637_ENABLE_METER
+  //! Start the level meter engine
+  //!
+  //! The meter is advanced by Animate() every tick: the bar moves towards the
+  //! largest sample received since the previous tick with the attack and decay
+  //! rates, and an optional peak marker holds the highest bar. Scaling and
+  //! decay use integer math and only digits whose bar pattern changed are sent.
+  //!
+  //! @param range Sample value of a full bar (samples are -range to range)
+  //! @param mode METER_BAR (left to right bars), METER_STACK (horizontal lines
+  //!             like showLevel()), optionally with METER_PEAK (peak-hold marker)
+  //!             and METER_CENTER (centre-zero bars, with METER_BAR)
+  //! @param tickMs Milliseconds between meter updates
+  void startMeter(int range = 100, uint8_t mode = METER_BAR | METER_PEAK, uint8_t tickMs = 10);
+
+  //! Set the dynamics of the level meter
+  //!
+  //! @param attack Fraction (1/256 per tick) of the distance moved towards a rising
+  //!               level, 0 = immediately
+  //! @param decay Fraction (1/256 per tick) of the distance moved towards a falling
+  //!              level, 0 = immediately
+  //! @param peakHoldMs Milliseconds the peak marker is held before it falls
+  void setMeterDynamics(uint8_t attack, uint8_t decay, unsigned int peakHoldMs = 1000);
+
+  //! Feed a raw sample to the level meter
+  //!
+  //! Can be called at any rate, the largest sample since the previous tick is used.
+  //! Samples are ignored while the meter is not started.
+  //!
+  //! @param sample A value between -range and range (negative values are only
+  //!               shown with METER_CENTER)
+  void meterSample(int sample);
+
+  //! Stop the level meter engine (the bars stay on the display)
+  //!
+  void stopMeter();
+#endif
   
   //! Display a sequence of raw LED segment data to create an animation
   //!
@@ -415,15 +712,84 @@ public:
   //! @param ms Time to delay between each frame
   void showAnimation_P(const uint8_t data[][4], unsigned int frames = 0, unsigned int ms = 10);
 
+#if TM1637_ENABLE_ANIMATION
   //! The event loop function to enable non-blocking animations
   //!
   //! The method returns TRUE when an animation is still occurring, it is
-  //! FALSE when there is no animation occurring
+  //! FALSE when there is no animation occurring. It also toggles any digits set
+  //! to blink by setBlink().
   //!
   //! @return A boolean value indicating if an animation is occurring
   //! @param loop If true, keep looping animation when it ends
   bool Animate(bool loop = false);
 
+  //! Time until the next non-blocking update is due
+  //!
+  //! Returns the number of milliseconds until Animate() needs to be called again to
+  //! show the next animation or scroll frame or to toggle a blink phase, so the
+  //! application can sleep in between. Returns 0 if an update is already due and
+  //! NO_DEADLINE if nothing is animating or blinking.
+  //!
+  //! @return Milliseconds until the next scheduled display change
+  unsigned long nextDeadlineMs();
+
+  //! Set blinking digits and decimal points (non-blocking)
+  //!
+  //! The blink attributes are applied on top of the stored digits each time the
+  //! display is written, so the content does not need to be re-rendered to blink.
+  //! The blink is driven by Animate() which must be called regularly. Each argument
+  //! is a bitmask with the same layout as the dots argument of showNumberDec()
+  //! (0b10000000 - leftmost digit).
+  //!
+  //! @param digits Bitmask of digits to blink (all segments)
+  //! @param dots Bitmask of digits where only the decimal point/colon blinks
+  //! @param ms Time in milliseconds that each blink phase (on or off) lasts
+  //! @param phase Bitmask of digits that blink in opposite phase to the others
+  void setBlink(uint8_t digits, uint8_t dots = 0, unsigned int ms = DEFAULT_BLINK_DELAY, uint8_t phase = 0);
+
+  //! Stop all blinking and show the stored digits
+  //!
+  void stopBlink();
+
+#if TM1637_ENABLE_TIMER
+  //! Start a non-blocking countdown or stopwatch
+  //!
+  //! The time is displayed by Animate() which must be called regularly. The display
+  //! switches format with the time shown (4-digit: ss.hh below a minute, mm:ss below
+  //! an hour, then hh:mm; 6-digit: mm.ss.hh below an hour, then hh.mm.ss) and only
+  //! digits that changed are sent. Timing is taken from millis() so it does not
+  //! depend on how often Animate() is called.
+  //!
+  //! @param ms Countdown time in milliseconds, or 0 to count up as a stopwatch
+  //! @param callback Function called once when the countdown reaches zero
+  void startTimer(unsigned long ms = 0, void (*callback)() = nullptr);
+
+  //! Pause the countdown or stopwatch (the time stays on the display)
+  //!
+  void pauseTimer();
+
+  //! Resume a paused countdown or stopwatch
+  //!
+  void resumeTimer();
+
+  //! Stop the countdown or stopwatch (the time stays on the display)
+  //!
+  void stopTimer();
+
+  //! Returns the remaining (countdown) or elapsed (stopwatch) time in milliseconds
+  //!
+  unsigned long readTimer();
+
+  //! Take a lap time
+  //!
+  //! @return Milliseconds of run time since the timer was started or the previous lap
+  unsigned long lapTimer();
+
+  //! Returns true while the countdown or stopwatch is running (not paused or stopped)
+  //!
+  bool isTimerRunning();
+#endif
+
   //! The function used to begin a non-blocking animation
   //!
   //! @param usePROGMEN Indicates if the passed animation data is coming from a PROGMEM defined variable
@@ -435,7 +801,8 @@ public:
   //! The function used to stop a non-blocking animation
   //!
   void stopAnimation();
- 
+
+#if TM1637_ENABLE_SCROLL
   //! The function used to begin a non-blocking scroll of a string
   //!
   //! @param usePROGMEN Indicates if the passed string data is coming from a PROGMEM defined variable
@@ -443,6 +810,29 @@ public:
   void startStringScroll(const char s[], unsigned int ms = DEFAULT_SCROLL_DELAY, bool usePROGMEM = false);
   void startStringScroll_P(const char s[], unsigned int ms = DEFAULT_SCROLL_DELAY);
 
+  //! The function used to begin a non-blocking scroll of text pulled from a source
+  //!
+  //! Animate() calls the source for the next character each frame, so the text
+  //! does not need to be in memory and may be of any length. The text is decoded
+  //! as UTF-8. When the source has no character yet the scroll waits for it.
+  //!
+  //! @param source Function returning the next byte, SOURCE_WAIT if none is
+  //!               available yet or SOURCE_END at the end of the text
+  //! @param context Pointer passed to the source function
+  //! @param ms Time to delay between each frame
+  void startSourceScroll(int (*source)(void *context), void *context = nullptr,
+    unsigned int ms = DEFAULT_SCROLL_DELAY);
+
+  //! The function used to begin a non-blocking scroll of text read from a Stream
+  //!
+  //! @param stream The stream to read (e.g. Serial or an SD card File)
+  //! @param ms Time to delay between each frame
+  //! @param live true to wait for more characters when the stream is empty (e.g.
+  //!        Serial), false to end the scroll when it is empty (e.g. a File)
+  void startStreamScroll(Stream &stream, unsigned int ms = DEFAULT_SCROLL_DELAY, bool live = false);
+#endif
+#endif
+
   //! Translate a single ASCII character into 7 segment code
   //!
   //! The method accepts a number between 0 - 255 and converts it to the
@@ -464,26 +854,157 @@ protected:
    bool writeByte(uint8_t b);
 
    void showDots(uint8_t dots, uint8_t* digits);
+
+   uint8_t formatChar(uint8_t *digits, uint8_t k, uint16_t c);
+
+   void renderString(const char *s, uint8_t length, uint8_t pos, uint8_t dots, bool usePROGMEM);
+
+#if TM1637_ENABLE_ANIMATION && TM1637_ENABLE_SCROLL
+   void scrollFrames(unsigned int frame, unsigned int last);
+
+   uint16_t scrollChar();
+#endif
+
+   void formatSegments(const char *fmt, va_list args, bool usePROGMEM);
+
+   void renderFrame(const uint8_t *src, uint8_t *frame);
+
+   uint8_t readByte(const void *p, bool usePROGMEM);
+
+#if TM1637_ENABLE_ANIMATION
+   uint8_t blinkHidden();
+
+   void blinkDigits(uint8_t *digits, uint8_t hidden);
+#endif
+
+   void writeChanged();
+
+#if TM1637_ENABLE_TIMER
+   unsigned long timerElapsed();
+
+   unsigned long timerUnit(unsigned long ms);
+
+   void showTimer();
+
+   void updateTimer();
+#endif
+
+#if TM1637_ENABLE_METER
+   int8_t meterBars();
+
+   int8_t meterLit();
+
+   void updateMeter();
+
+   void showMeter();
+#endif
+
+   void compileFrame(TM1637Waveform &wave, const uint8_t *frame);
+
+#if TM1637_ENABLE_CAPTURE
+   void captureFrame();
+#endif
+
+   uint32_t nowMs();
+
+   void waitMs(uint32_t ms);
+
    
    void showNumberBaseEx(int8_t base, uint16_t num, uint8_t dots = 0, bool leading_zero = false, uint8_t length = MAXDIGITS, uint8_t pos = 0);
 
 private:
+  // Members are ordered by size so the object packs without padding
+#if TM1637_ENABLE_STATS
+  TM1637Stats m_stats;
+#endif
+#if TM1637_ENABLE_ANIMATION
+  uint32_t m_animation_start;
+  uint32_t m_blink_start;
+#if TM1637_ENABLE_TIMER
+  uint32_t m_timer_start;
+  unsigned long m_timer_base;
+  unsigned long m_timer_duration;
+  unsigned long m_timer_lap;
+  void (*m_timer_callback)();
+#endif
+#if TM1637_ENABLE_METER
+  uint32_t m_meter_tick;
+  uint32_t m_meter_peak_start;
+#endif
+  union {
+    uint8_t (*m_animation_sequence)[MAXDIGITS];
+#if TM1637_ENABLE_SCROLL
+    uint8_t *m_animation_string;
+    int (*m_scroll_source)(void *context);
+#endif
+  };
+#if TM1637_ENABLE_SCROLL
+  union {
+    const char *m_scroll_next;
+    void *m_scroll_context;
+  };
+#endif
+  unsigned int m_animation_frames;
+  unsigned int m_animation_last_frame;
+  unsigned int m_animation_frame_ms;
+  unsigned int m_blink_ms;
+#if TM1637_ENABLE_SCROLL
+  int m_scroll_peek;
+  TM1637UTF8 m_scroll_utf8;
+#endif
+#if TM1637_ENABLE_METER
+  int m_meter_range;
+  int m_meter_level;
+  int m_meter_input;
+  unsigned int m_meter_hold;
+#endif
+#endif
+#if TM1637_ENABLE_CAPTURE
+  TM1637Capture *m_capture;
+#endif
+#if TM1637_ENABLE_TIME_SOURCE
+  const TM1637TimeSource *m_time;
+#endif
+  unsigned int m_bitDelay;
+#if TM1637_ENABLE_SCROLL
+  unsigned int m_scrollDelay;
+#endif
   uint8_t m_pinClk;
   uint8_t m_pinDIO;
   uint8_t m_brightness;
-  unsigned int m_bitDelay;
-  unsigned int m_scrollDelay;
-  bool m_flipDisplay;
-  uint8_t digits[MAXDIGITS];
   uint8_t digitsbuf[MAXDIGITS];
-
-  unsigned long m_animation_start;
-  unsigned int m_animation_frames;
-  unsigned int m_animation_last_frame;
-  unsigned int m_animation_frame_ms;
-  uint8_t (*m_animation_sequence)[MAXDIGITS];
-  uint8_t *m_animation_string;
+  uint8_t m_frame[MAXDIGITS];
+  bool m_frameValid;  // m_frame has been sent since begin()
+#if TM1637_ENABLE_USI
+  uint8_t m_transport;
+#endif
+#if TM1637_ENABLE_FLIP
+  uint8_t m_orientation;
+#endif
+#if TM1637_ENABLE_CLOCK
+  uint8_t m_clock_hours;
+  uint8_t m_clock_minutes;
+  uint8_t m_clock_seconds;
+  bool m_clock_blink;
+#endif
+#if TM1637_ENABLE_ANIMATION
   uint8_t m_animation_type;
+  uint8_t m_blink_digits;
+  uint8_t m_blink_dots;
+  uint8_t m_blink_phase;
+  uint8_t m_blink_state;
+#endif
+#if TM1637_ENABLE_TIMER
+  uint8_t m_timer_state;
+#endif
+#if TM1637_ENABLE_METER
+  int8_t m_meter_peak;
+  uint8_t m_meter_mode;
+  uint8_t m_meter_ms;
+  uint8_t m_meter_attack;
+  uint8_t m_meter_decay;
+  bool m_meter_new;
+#endif
 };
 
 #endif // __TM1637TINYDISPLAY__
@@ -28,154 +28,116 @@ extern "C" {
 
 #include <TM1637TinyDisplay6.h>
 #include <Arduino.h>
+#if TM1637_FIXED_PINS
+#include <TM1637Pins.h>
+
+// Bus of a display on the pins the library is built for
+typedef TM1637Pins<TM1637_CLK_PIN, TM1637_DIO_PIN> FixedPins;
+#endif
 
 #define labs(x) ((x)>0?(x):-(x))
 
 // Digit sequence map for 6 digit displays
 const uint8_t digitmap[] = { 2, 1, 0, 5, 4, 3 }; 
 
-//
-//      A
-//     ---
-//  F |   | B
-//     -G-
-//  E |   | C
-//     ---
-//      D
-const uint8_t digitToSegment[] PROGMEM = {
- // XGFEDCBA
-  0b00111111,    // 0
-  0b00000110,    // 1
-  0b01011011,    // 2
-  0b01001111,    // 3
-  0b01100110,    // 4
-  0b01101101,    // 5
-  0b01111101,    // 6
-  0b00000111,    // 7
-  0b01111111,    // 8
-  0b01101111,    // 9
-  0b01110111,    // A
-  0b01111100,    // b
-  0b00111001,    // C
-  0b01011110,    // d
-  0b01111001,    // E
-  0b01110001     // F
-  };
-
-// ASCII Map - Index 0 starts at ASCII 32
-const uint8_t asciiToSegment[] PROGMEM = {
-   0b00000000, // 032 (Space)
-   0b00000110, // 033 !
-   0b00100010, // 034 "
-   0b01000001, // 035 #
-   0b01101101, // 036 $
-   0b01010010, // 037 %
-   0b01111100, // 038 &
-   0b00000010, // 039 '
-   0b00111001, // 040 (
-   0b00001111, // 041 )
-   0b00100001, // 042 *
-   0b01110000, // 043 +
-   0b00001000, // 044 ,
-   0b01000000, // 045 -
-   0b00001000, // 046 .
-   0b01010010, // 047 /
-   0b00111111, // 048 0
-   0b00000110, // 049 1
-   0b01011011, // 050 2
-   0b01001111, // 051 3
-   0b01100110, // 052 4
-   0b01101101, // 053 5
-   0b01111101, // 054 6
-   0b00000111, // 055 7
-   0b01111111, // 056 8
-   0b01101111, // 057 9
-   0b01001000, // 058 :
-   0b01001000, // 059 ;
-   0b01100001, // 060 <
-   0b01001000, // 061 =
-   0b01000011, // 062 >
-   0b01010011, // 063 ?
-   0b01111011, // 064 @
-   0b01110111, // 065 A
-   0b01111100, // 066 B
-   0b00111001, // 067 C
-   0b01011110, // 068 D
-   0b01111001, // 069 E
-   0b01110001, // 070 F
-   0b00111101, // 071 G
-   0b01110110, // 072 H
-   0b00000110, // 073 I
-   0b00011110, // 074 J
-   0b01110010, // 075 K
-   0b00111000, // 076 L
-   0b00110011, // 077 M (For display use Mm)
-   0b00110111, // 078 N
-   0b00111111, // 079 O
-   0b01110011, // 080 P
-   0b01100111, // 081 Q
-   0b00110001, // 082 R
-   0b01101101, // 083 S
-   0b01111000, // 084 T
-   0b00111110, // 085 U
-   0b00111110, // 086 V
-   0b00111100, // 087 W (For display use Ww)
-   0b01110110, // 088 X
-   0b01101110, // 089 Y
-   0b01011011, // 090 Z
-   0b00111001, // 091 [
-   0b01100100, // 092 (backslash)
-   0b00001111, // 093 ]
-   0b00100011, // 094 ^
-   0b00001000, // 095 _
-   0b00100000, // 096 `
-   0b01011111, // 097 a
-   0b01111100, // 098 b
-   0b01011000, // 099 c
-   0b01011110, // 100 d
-   0b01111011, // 101 e
-   0b01110001, // 102 f
-   0b01101111, // 103 g
-   0b01110100, // 104 h
-   0b00000100, // 105 i
-   0b00001110, // 106 j
-   0b01110000, // 107 k
-   0b00011000, // 108 l
-   0b00100111, // 109 m (For display use nn)
-   0b01010100, // 110 n
-   0b01011100, // 111 o
-   0b01110011, // 112 p
-   0b01100111, // 113 q
-   0b01010000, // 114 r
-   0b01101101, // 115 s
-   0b01111000, // 116 t
-   0b00011100, // 117 u
-   0b00011100, // 118 v
-   0b00011110, // 119 w (For display use uu) 
-   0b01110110, // 120 x
-   0b01101110, // 121 y
-   0b01011011, // 122 z
-   0b01000110, // 123 {
-   0b00110000, // 124 |
-   0b01110000, // 125 }
-   0b01000000, // 126 ~
-   0b00000000  // 127 
-};
-
 static const uint8_t minusSegments = 0b01000000;
-static const uint8_t degreeSegments = 0b01100011;
+
+#if TM1637_ENABLE_ANIMATION && TM1637_ENABLE_SCROLL
+// Scroll sources reading a Stream - read() returns -1 (SOURCE_END) when it is empty
+static int readStream(void *context)
+{
+  return ((Stream *)context)->read();
+}
+
+static int readStreamLive(void *context)
+{
+  int c = ((Stream *)context)->read();
+  return c < 0 ? SOURCE_WAIT : c;
+}
+#endif
 
 TM1637TinyDisplay6::TM1637TinyDisplay6(uint8_t pinClk, uint8_t pinDIO, 
- unsigned int bitDelay, unsigned int scrollDelay, bool flip)
+ unsigned int bitDelay, unsigned int scrollDelay, bool flip, uint8_t transport)
 {
   // Pin settings
   m_pinClk = pinClk;
   m_pinDIO = pinDIO;
+#if TM1637_ENABLE_USI
+  m_transport = transport;
+#else
+  (void)transport;
+#endif
+#if TM1637_ENABLE_CAPTURE
+  m_capture = nullptr;
+#endif
+#if TM1637_ENABLE_TIME_SOURCE
+  m_time = nullptr;
+#endif
+  // Display on at full brightness, as begin() sets it
+  m_brightness = BRIGHT_HIGH;
   // Timing configurations
   m_bitDelay = bitDelay;
+#if TM1637_ENABLE_SCROLL
   m_scrollDelay = scrollDelay;
+#else
+  (void)scrollDelay;
+#endif
+#if TM1637_ENABLE_STATS
+  resetStats();
+#endif
+  // Display buffers
+  memset(digitsbuf,0,sizeof(digitsbuf));
+  memset(m_frame,0,sizeof(m_frame));
+  m_frameValid = false;
+#if TM1637_ENABLE_CLOCK
+  // Clock
+  m_clock_hours = 0;
+  m_clock_minutes = 0;
+  m_clock_seconds = 0;
+  m_clock_blink = true;
+#endif
+#if TM1637_ENABLE_FLIP
   // Flip 
-  m_flipDisplay = flip;
+  m_orientation = flip ? ORIENTATION_FLIP : ORIENTATION_NORMAL;
+#else
+  (void)flip;
+#endif
+#if TM1637_ENABLE_ANIMATION
+  // Animation and blink attributes
+  m_animation_type = 0;
+  m_blink_digits = 0;
+  m_blink_dots = 0;
+  m_blink_phase = 0;
+  m_blink_state = 0;
+  m_blink_ms = DEFAULT_BLINK_DELAY;
+#if TM1637_ENABLE_SCROLL
+  m_scroll_peek = SOURCE_WAIT;
+  m_scroll_utf8.reset();
+#endif
+#endif
+#if TM1637_ENABLE_TIMER
+  // Countdown/stopwatch
+  m_timer_state = TIMER_STOPPED;
+  m_timer_duration = 0;
+  m_timer_base = 0;
+  m_timer_lap = 0;
+  m_timer_callback = nullptr;
+#endif
+#if TM1637_ENABLE_METER
+  // Level meter
+  m_meter_mode = 0;
+  m_meter_range = 1;
+  m_meter_ms = 1;
+  m_meter_level = 0;
+  m_meter_input = 0;
+  m_meter_peak = 0;
+  m_meter_new = false;
+  m_meter_tick = 0;
+  m_meter_peak_start = 0;
+  m_meter_attack = 0;
+  m_meter_decay = 32;
+  m_meter_hold = 1000;
+#endif
 }
 
 void TM1637TinyDisplay6::begin(bool clearDisplay)
@@ -186,6 +148,13 @@ void TM1637TinyDisplay6::begin(bool clearDisplay)
   pinMode(m_pinDIO, INPUT);
   digitalWrite(m_pinClk, LOW);
   digitalWrite(m_pinDIO, LOW);
+  // Display RAM is undefined until a full frame is written
+  m_frameValid = false;
+#if TM1637_ENABLE_USI
+  // Use the USI only when the display is wired to its pins
+  if (m_transport == TRANSPORT_USI && !TM1637USI::begin(m_pinClk, m_pinDIO))
+    m_transport = TRANSPORT_BITBANG;
+#endif
   if (clearDisplay)
   {
     clear();
@@ -193,36 +162,123 @@ void TM1637TinyDisplay6::begin(bool clearDisplay)
   }
 }
 
-void TM1637TinyDisplay6::flipDisplay(bool flip)
+void TM1637TinyDisplay6::beginFrame(const uint8_t frame[], uint8_t brightness,
+  unsigned int initBitDelay, bool usePROGMEM)
 {
-  m_flipDisplay = flip;
+  begin(false);
+  for (uint8_t k=0; k < MAXDIGITS; k++) {
+    digitsbuf[k] = readByte(frame + k, usePROGMEM);
+  }
+  renderFrame(digitsbuf, m_frame);
+
+  // Data command + frame, then display control - no clear before the frame
+  unsigned int bitDelay = m_bitDelay;
+  if (initBitDelay) m_bitDelay = initBitDelay;
   writeBuffer();
+  setBrightness(brightness);
+  m_bitDelay = bitDelay;
+}
+
+void TM1637TinyDisplay6::beginFrame_P(const uint8_t frame[], uint8_t brightness, unsigned int initBitDelay)
+{
+  beginFrame(frame, brightness, initBitDelay, true);
+}
+
+#if TM1637_ENABLE_FLIP
+void TM1637TinyDisplay6::flipDisplay(bool flip)
+{
+  setOrientation(flip ? ORIENTATION_FLIP : ORIENTATION_NORMAL);
 }
 
 bool TM1637TinyDisplay6::isflipDisplay()
 {
-  return(m_flipDisplay);
+  return(m_orientation == ORIENTATION_FLIP);
+}
+
+void TM1637TinyDisplay6::setOrientation(uint8_t orientation)
+{
+  m_orientation = orientation & ORIENTATION_FLIP;
+  renderFrame(digitsbuf, m_frame);
+  writeBuffer();
+}
+
+uint8_t TM1637TinyDisplay6::getOrientation()
+{
+  return(m_orientation);
 }
+#endif
 
 void TM1637TinyDisplay6::setBrightness(uint8_t brightness, bool on)
 {
+#if TM1637_ENABLE_STATS
+  TM1637StatsTimer timer(m_stats, STATS_BRIGHTNESS);
+#endif
   m_brightness = (brightness & 0x07) | (on? 0x08 : 0x00);
   
   // Write COMM3 + brightness
   start();
   writeByte(TM1637_I2C_COMM3 + (m_brightness & 0x0f));
   stop();
+#if TM1637_ENABLE_CAPTURE
+  if (m_capture != nullptr) m_capture->record(nowMs(), m_brightness);
+#endif
 }
 
+#if TM1637_ENABLE_SCROLL
 void TM1637TinyDisplay6::setScrolldelay(unsigned int scrollDelay)
 {
   m_scrollDelay = scrollDelay;
 }
+#endif
+
+#if TM1637_ENABLE_ANIMATION
+uint8_t TM1637TinyDisplay6::blinkHidden()
+{
+  return (m_blink_state ? ~m_blink_phase : m_blink_phase) & (m_blink_digits | m_blink_dots);
+}
+
+void TM1637TinyDisplay6::blinkDigits(uint8_t *digits, uint8_t hidden)
+{
+  for (uint8_t k=0; k < MAXDIGITS; k++) {
+    uint8_t mask = 0x80 >> k;
+    digits[k] = digitsbuf[k];
+    if (hidden & mask) {
+      if (m_blink_digits & mask) digits[k] = 0;
+      if (m_blink_dots & mask) digits[k] &= ~0b10000000;
+    }
+  }
+}
+#endif
 
 void TM1637TinyDisplay6::writeBuffer()
 {
-  uint8_t dot = 0;
-  
+#if TM1637_ENABLE_STATS
+  TM1637StatsTimer timer(m_stats, STATS_WRITEBUFFER);
+#endif
+  // m_frame holds the oriented digits, ready to send
+  const uint8_t *frame = m_frame;
+#if TM1637_ENABLE_ANIMATION
+  uint8_t blinkframe[MAXDIGITS];
+
+  // Apply blink attributes on top of the stored digits
+  uint8_t hidden = blinkHidden();
+  if (hidden) {
+    uint8_t digits[MAXDIGITS];
+    blinkDigits(digits, hidden);
+    renderFrame(digits, blinkframe);
+    frame = blinkframe;
+  }
+#endif
+
+#if TM1637_ENABLE_WAVEFORM
+  TM1637Waveform wave;
+  compileFrame(wave, frame);
+  playWaveform(wave);
+#if TM1637_ENABLE_STATS
+  m_stats.transactions += 2;
+  m_stats.bytes += MAXDIGITS + 2;
+#endif
+#else
   // Write COMM1
   start();
   writeByte(TM1637_I2C_COMM1);
@@ -233,25 +289,234 @@ void TM1637TinyDisplay6::writeBuffer()
   writeByte(TM1637_I2C_COMM2 + (digitmap[MAXDIGITS - 1] & 0x07));
 
   // Write the data bytes
-  if(m_flipDisplay) {
-    for (uint8_t k=0; k < MAXDIGITS; k++) {
-      dot = 0;
-      if((k - 1) >= 0 ) {
-        dot = digitsbuf[k - 1] & 0b10000000;
-      }
-      uint8_t orig = digitsbuf[k];
-      uint8_t flip = ((orig >> 3) & 0b00000111) + 
-        ((orig << 3) & 0b00111000) + (orig & 0b01000000) + dot;
-      writeByte(flip);
-    } 
+  for (uint8_t k=0; k < MAXDIGITS; k++) {
+    writeByte(frame[k]);
+  }
+  stop();
+#endif
+  m_frameValid = true;
+#if TM1637_ENABLE_CAPTURE
+  captureFrame();
+#endif
+}
+
+TM1637TinyDisplay6::State TM1637TinyDisplay6::saveState()
+{
+  State state;
+  uint32_t now = nowMs();
+#if TM1637_ENABLE_ANIMATION
+  state.animationElapsed = now - m_animation_start;
+  state.blinkElapsed = now - m_blink_start;
+#if TM1637_ENABLE_SCROLL
+  if (m_animation_type == 5) {
+    state.scrollSource = m_scroll_source;
+    state.scrollContext = m_scroll_context;
+  }
+  else {
+    state.animationSequence = m_animation_sequence;
+    state.scrollNext = m_scroll_next;
+  }
+  state.scrollPeek = m_scroll_peek;
+  state.scrollDecoder = m_scroll_utf8;
+#else
+  state.animationSequence = m_animation_sequence;
+#endif
+  state.animationFrames = m_animation_frames;
+  state.animationLastFrame = m_animation_last_frame;
+  state.animationFrameMs = m_animation_frame_ms;
+  state.blinkMs = m_blink_ms;
+  state.animationType = m_animation_type;
+  state.blinkDigits = m_blink_digits;
+  state.blinkDots = m_blink_dots;
+  state.blinkPhase = m_blink_phase;
+  state.blinkState = m_blink_state;
+#else
+  (void)now;
+#endif
+  memcpy(state.digits, digitsbuf, sizeof(state.digits));
+  state.brightness = m_brightness;
+#if TM1637_ENABLE_FLIP
+  state.orientation = m_orientation;
+#endif
+  return state;
+}
+
+void TM1637TinyDisplay6::restoreState(const State &state)
+{
+  uint32_t now = nowMs();
+#if TM1637_ENABLE_ANIMATION
+  // Continue the animation and blink where they were
+  m_animation_start = now - state.animationElapsed;
+  m_blink_start = now - state.blinkElapsed;
+#if TM1637_ENABLE_SCROLL
+  if (state.animationType == 5) {
+    m_scroll_source = state.scrollSource;
+    m_scroll_context = state.scrollContext;
   }
   else {
-    for (uint8_t k=0; k < MAXDIGITS; k++) {
-      // 6 digit display - send in reverse order
-      writeByte(digitsbuf[MAXDIGITS - 1 - k]); 
+    m_animation_sequence = state.animationSequence;
+    m_scroll_next = state.scrollNext;
+  }
+  m_scroll_peek = state.scrollPeek;
+  m_scroll_utf8 = state.scrollDecoder;
+#else
+  m_animation_sequence = state.animationSequence;
+#endif
+  m_animation_frames = state.animationFrames;
+  m_animation_last_frame = state.animationLastFrame;
+  m_animation_frame_ms = state.animationFrameMs;
+  m_blink_ms = state.blinkMs;
+  m_animation_type = state.animationType;
+  m_blink_digits = state.blinkDigits;
+  m_blink_dots = state.blinkDots;
+  m_blink_phase = state.blinkPhase;
+  m_blink_state = state.blinkState;
+#else
+  (void)now;
+#endif
+#if TM1637_ENABLE_FLIP
+  m_orientation = state.orientation;
+#endif
+
+  // One update with the saved digits
+  memcpy(digitsbuf, state.digits, sizeof(digitsbuf));
+  renderFrame(digitsbuf, m_frame);
+  writeBuffer();
+  if (state.brightness != m_brightness) {
+    setBrightness(state.brightness & 0x07, state.brightness & 0x08);
+  }
+}
+
+bool TM1637TinyDisplay6::compileBuffer(TM1637Waveform &wave)
+{
+  wave.clear();
+  compileFrame(wave, m_frame);
+
+  // COMM3 + brightness
+  wave.start();
+  wave.write(TM1637_I2C_COMM3 + (m_brightness & 0x0f));
+  wave.stop();
+  return !wave.overflow();
+}
+
+void TM1637TinyDisplay6::compileFrame(TM1637Waveform &wave, const uint8_t *frame)
+{
+  // COMM1
+  wave.start();
+  wave.write(TM1637_I2C_COMM1);
+  wave.stop();
+
+  // COMM2 + first digit address and the data bytes
+  wave.start();
+  wave.write(TM1637_I2C_COMM2 + (digitmap[MAXDIGITS - 1] & 0x07));
+  for (uint8_t k=0; k < MAXDIGITS; k++) {
+    wave.write(frame[k]);
+  }
+  wave.stop();
+}
+
+void TM1637TinyDisplay6::playWaveform(const TM1637Waveform &wave)
+{
+#if TM1637_ENABLE_STATS
+  // One delay per line state (the lines are set with register writes on AVR, not counted)
+  m_stats.bitDelays += wave.length();
+  m_stats.delayUs += (unsigned long)m_bitDelay * wave.length();
+#endif
+  wave.play(m_pinClk, m_pinDIO, m_bitDelay);
+}
+
+void TM1637TinyDisplay6::renderFrame(const uint8_t *src, uint8_t *frame)
+{
+  // Compute the byte for each digit position in the order it is sent
+  // (6 digit display - send in reverse order)
+  for (uint8_t k=0; k < MAXDIGITS; k++) {
+    uint8_t i = MAXDIGITS - 1 - k;
+#if TM1637_ENABLE_FLIP
+    if (m_orientation != ORIENTATION_NORMAL) {
+      uint8_t dot;
+      if (m_orientation & ORIENTATION_MIRROR) {
+        // Digit order is reversed so the dot comes from the neighbouring digit
+        i = MAXDIGITS - 1 - i;
+        dot = (i > 0) ? (src[i - 1] & 0b10000000) : 0;
+      }
+      else {
+        dot = src[i] & 0b10000000;
+      }
+      uint8_t seg = src[i] & 0b01111111;
+      if (m_orientation & ORIENTATION_MIRROR_V) {
+        // Top to bottom mirror is a rotation of the left to right mirror
+        if (!(m_orientation & ORIENTATION_MIRROR)) {
+          seg = readByte(TM1637Font::mirrorSegments + seg, true);
+        }
+        seg = readByte(TM1637Font::rotateSegments + seg, true);
+      }
+      else {
+        seg = readByte(TM1637Font::mirrorSegments + seg, true);
+      }
+      frame[k] = seg | dot;
+      continue;
     }
+#endif
+    frame[k] = src[i];
   }
-  stop();
+}
+
+#if TM1637_ENABLE_STATS
+TM1637Stats TM1637TinyDisplay6::getStats()
+{
+  return m_stats;
+}
+
+void TM1637TinyDisplay6::resetStats()
+{
+  memset(&m_stats, 0, sizeof(m_stats));
+}
+#endif
+
+#if TM1637_ENABLE_CAPTURE
+void TM1637TinyDisplay6::setCapture(TM1637Capture *capture)
+{
+  m_capture = capture;
+}
+
+void TM1637TinyDisplay6::captureFrame()
+{
+  if (m_capture == nullptr) return;
+  // Record the digits as shown, leftmost first and before orientation
+  uint8_t digits[MAXDIGITS];
+#if TM1637_ENABLE_ANIMATION
+  blinkDigits(digits, blinkHidden());
+#else
+  memcpy(digits, digitsbuf, MAXDIGITS);
+#endif
+  m_capture->record(nowMs(), digits, MAXDIGITS, m_brightness);
+}
+#endif
+
+#if TM1637_ENABLE_TIME_SOURCE
+void TM1637TinyDisplay6::setTimeSource(const TM1637TimeSource *source)
+{
+  m_time = source;
+}
+#endif
+
+uint32_t TM1637TinyDisplay6::nowMs()
+{
+#if TM1637_ENABLE_TIME_SOURCE
+  if (m_time != nullptr) return m_time->now();
+#endif
+  return millis();
+}
+
+void TM1637TinyDisplay6::waitMs(uint32_t ms)
+{
+#if TM1637_ENABLE_TIME_SOURCE
+  if (m_time != nullptr) {
+    m_time->wait(ms);
+    return;
+  }
+#endif
+  delay(ms);
 }
 
 void TM1637TinyDisplay6::readBuffer(uint8_t *buffercopy)
@@ -271,18 +536,94 @@ void TM1637TinyDisplay6::setSegments(const uint8_t segments[], uint8_t length, u
   }
 
   // Write buffer to Display
+  renderFrame(digitsbuf, m_frame);
   writeBuffer();
 }
 
 void TM1637TinyDisplay6::setSegments(uint8_t A, uint8_t pos) 
 {
   digitsbuf[pos] = A;  
+  renderFrame(digitsbuf, m_frame);
   writeBuffer();
 }
 
+void TM1637TinyDisplay6::setFrame(const uint8_t frame[], bool usePROGMEM)
+{
+  uint8_t k;
+
+  // Nothing to send if the frame is already displayed
+  for (k=0; k < MAXDIGITS; k++) {
+    uint8_t b = readByte(frame + k, usePROGMEM);
+    if (b != digitsbuf[k]) break;
+  }
+  if (m_frameValid && k == MAXDIGITS) return;
+
+  bool direct = true;
+#if TM1637_ENABLE_WAVEFORM
+  // Waveform builds send every frame through the compiled waveform
+  direct = false;
+#endif
+#if TM1637_ENABLE_FLIP
+  if (m_orientation != ORIENTATION_NORMAL) direct = false;
+#endif
+#if TM1637_ENABLE_ANIMATION
+  if (m_blink_digits | m_blink_dots) direct = false;
+#endif
+  if (!direct) {
+    for (k=0; k < MAXDIGITS; k++) {
+      digitsbuf[k] = readByte(frame + k, usePROGMEM);
+    }
+    renderFrame(digitsbuf, m_frame);
+    writeBuffer();
+    return;
+  }
+
+  // Timed like writeBuffer()
+#if TM1637_ENABLE_STATS
+  TM1637StatsTimer timer(m_stats, STATS_WRITEBUFFER);
+#endif
+
+  // Write COMM1
+  start();
+  writeByte(TM1637_I2C_COMM1);
+  stop();
+
+  // Write COMM2 + start with last digit address on 6-digit display
+  start();
+  writeByte(TM1637_I2C_COMM2 + (digitmap[MAXDIGITS - 1] & 0x07));
+
+  // Write the data bytes straight from the caller's frame
+  for (k=0; k < MAXDIGITS; k++) {
+    uint8_t i = MAXDIGITS - 1 - k;  // 6 digit display - send in reverse order
+    uint8_t b = readByte(frame + i, usePROGMEM);
+    digitsbuf[i] = b;
+    m_frame[k] = b;
+    writeByte(b);
+  }
+  stop();
+  m_frameValid = true;
+#if TM1637_ENABLE_CAPTURE
+  captureFrame();
+#endif
+}
+
+void TM1637TinyDisplay6::setFrame_P(const uint8_t frame[])
+{
+  setFrame(frame, true);
+}
+
+bool TM1637TinyDisplay6::flushMailbox(TM1637FrameMailbox &mailbox)
+{
+  const uint8_t *frame = mailbox.fetch();
+  if (frame == nullptr) return false;
+  setFrame(frame);
+  return true;
+}
+
 void TM1637TinyDisplay6::clear()
 {
   // digits[MAXDIGITS] output array to render
+  uint8_t digits[MAXDIGITS];
   memset(digits,0,sizeof(digits));
   setSegments(digits);
 }
@@ -296,12 +637,40 @@ void TM1637TinyDisplay6::showNumber(long num, bool leading_zero, uint8_t length,
 {
   if(leading_zero) {
     showNumberDec(num, 0, leading_zero, length, pos);
+    return;
   }
-  else {
-    showNumber(double(num), 0, length, pos);
+  // Integer only rendering - no floating point math required
+  // digits[MAXDIGITS] output array to render
+  uint8_t digits[MAXDIGITS];
+  memset(digits,0,sizeof(digits));
+  unsigned long inum = (num < 0) ? -(unsigned long)num : num;
+
+  // determine length of number including negative sign
+  uint8_t num_len = (num < 0) ? 1 : 0;
+  unsigned long n = inum;
+  do {
+    num_len++;
+    n /= 10;
+    STATS_COUNT(divides, 1);
+  } while(n != 0);
+  // make sure we can display number otherwise show overflow
+  if(num_len > length) {
+    showString("------", length, pos); // overflow symbol
+    return;
+  }
+  // render display array
+  for(int i = length-1; i >= length - num_len; --i) {
+    digits[i] = encodeDigit(inum % 10);
+    inum /= 10;
+    STATS_COUNT(divides, 2);
+  }
+  if(num < 0) {
+    digits[length - num_len] = minusSegments;
   }
+  setSegments(digits, length, pos);
 }
 
+#if TM1637_ENABLE_FLOAT
 void TM1637TinyDisplay6::showNumber(double num, uint8_t decimal_length, uint8_t length, uint8_t pos)
 {
   int num_len = 0;              
@@ -311,12 +680,14 @@ void TM1637TinyDisplay6::showNumber(double num, uint8_t decimal_length, uint8_t
   bool negative = false; 
   bool leading_zero = false; 
   // digits[MAXDIGITS] output array to render
+  uint8_t digits[MAXDIGITS];
   memset(digits,0,sizeof(digits));
 
   // determine length of whole number part of num
   while(inum != 0) {  
     inum = inum / 10;
     num_len++;
+    STATS_COUNT(divides, 1);
   }
   if(num < 0) {
     num_len++; // make space for negative
@@ -371,10 +742,12 @@ void TM1637TinyDisplay6::showNumber(double num, uint8_t decimal_length, uint8_t
         digits[i] += 0b10000000; // add decimal point
       }
       inum /= 10;
+      STATS_COUNT(divides, 2);
     }
   }
   setSegments(digits, length, pos);
 }
+#endif
 
 void TM1637TinyDisplay6::showNumberDec(long num, uint8_t dots, bool leading_zero,
                                     uint8_t length, uint8_t pos)
@@ -391,6 +764,9 @@ void TM1637TinyDisplay6::showNumberHex(uint16_t num, uint8_t dots, bool leading_
 void TM1637TinyDisplay6::showNumberBaseEx(int8_t base, uint32_t num, uint8_t dots, bool leading_zero,
                                     uint8_t length, uint8_t pos)
 {
+  // digits[MAXDIGITS] output array to render
+  uint8_t digits[MAXDIGITS];
+  memset(digits,0,sizeof(digits));
   bool negative = false;
   if (base < 0) {
     base = -base;
@@ -420,6 +796,7 @@ void TM1637TinyDisplay6::showNumberBaseEx(int8_t base, uint32_t num, uint8_t dot
       }
 
       num /= base;
+      STATS_COUNT(divides, 2);
     }
   }
   if(dots != 0) {
@@ -429,111 +806,468 @@ void TM1637TinyDisplay6::showNumberBaseEx(int8_t base, uint32_t num, uint8_t dot
 }
 
 void TM1637TinyDisplay6::showString(const char s[], uint8_t length, uint8_t pos, uint8_t dots)
+{
+  renderString(s, length, pos, dots, false);
+}
+
+void TM1637TinyDisplay6::showString_P(const char s[], uint8_t length, uint8_t pos, uint8_t dots) 
+{
+  renderString(s, length, pos, dots, true);
+}
+
+void TM1637TinyDisplay6::renderString(const char *s, uint8_t length, uint8_t pos, uint8_t dots, bool usePROGMEM)
 {
   // digits[MAXDIGITS] output array to render
+  uint8_t digits[MAXDIGITS];
   memset(digits,0,sizeof(digits));
 
+  // Decode the UTF-8 text until the display is full
+  const char *p = s;
+  uint8_t count = 0;
+  uint16_t c;
+  while (count < MAXDIGITS && (c = TM1637Font::decodeUTF8(p, usePROGMEM)) != 0) {
+    digits[count++] = TM1637Font::encodeCodepoint(c);
+    STATS_COUNT(progmemReads, 1 + usePROGMEM);
+  }
+  bool overflow = TM1637Font::decodeUTF8(p, usePROGMEM) != 0;
+
   // Basic Display
-  if (strlen(s) <= MAXDIGITS) {
-    for (size_t x = 0; x < strlen(s); x++) {
-      digits[x] = encodeASCII(s[x]);
-    }
+  if (!overflow || !TM1637_ENABLE_SCROLL) {
     if(dots != 0) {
       showDots(dots, digits);
     }
     setSegments(digits, length, pos);
   }
-  // Scrolling Display
-  if (strlen(s) > MAXDIGITS) {
+#if TM1637_ENABLE_SCROLL
+  else {
     // Scroll text on display if too long
-    for (int x = 0; x < (MAXDIGITS-1); x++) {  // Scroll message on
-      int y;
-      for (y = 0; y < (MAXDIGITS-1); y++) {
-        // shift left
-        digits[y] = digits[y+1];
-      }
-      digits[y] = encodeASCII(s[x]);
-      setSegments(digits, length, pos);
-      delay(m_scrollDelay);
-    }
-    for (size_t x = (MAXDIGITS-1); x < strlen(s); x++) { // Scroll through string
+    memset(digits,0,sizeof(digits));
+    p = s;
+    while ((c = TM1637Font::decodeUTF8(p, usePROGMEM)) != 0) { // Scroll message on and through
       int y;
       for (y = 0; y < (MAXDIGITS-1); y++) {
         // shift left
         digits[y] = digits[y+1];
       }
-      digits[y] = encodeASCII(s[x]);
+      digits[y] = TM1637Font::encodeCodepoint(c);
+      STATS_COUNT(progmemReads, 1 + usePROGMEM);
       setSegments(digits, length, pos);
-      delay(m_scrollDelay);
+      waitMs(m_scrollDelay);
     }
     for (int x = 0; x < (MAXDIGITS); x++) {  // Scroll message off
-          int y;
+      int y;
       for (y = 0; y < (MAXDIGITS-1); y++) {
         // shift left
         digits[y] = digits[y+1];
       }
       digits[y] = 0;
       setSegments(digits, length, pos);
-      delay(m_scrollDelay);
+      waitMs(m_scrollDelay);
     }
   }
+#endif
 }
 
-void TM1637TinyDisplay6::showString_P(const char s[], uint8_t length, uint8_t pos, uint8_t dots) 
+void TM1637TinyDisplay6::showFormat(const char fmt[], ...)
 {
-  // digits[MAXDIGITS] output array to render
-  memset(digits,0,sizeof(digits));
+  va_list args;
+  va_start(args, fmt);
+  formatSegments(fmt, args, false);
+  va_end(args);
+}
 
-  // Basic Display
-  if (strlen_P(s) <= MAXDIGITS) {
-    for (size_t x = 0; x < strlen_P(s); x++) {
-      digits[x] = encodeASCII(pgm_read_byte(&s[x]));
-    }
-    if(dots != 0) {
-      showDots(dots, digits);
+void TM1637TinyDisplay6::showFormat_P(const char fmt[], ...)
+{
+  va_list args;
+  va_start(args, fmt);
+  formatSegments(fmt, args, true);
+  va_end(args);
+}
+
+uint8_t TM1637TinyDisplay6::formatChar(uint8_t *digits, uint8_t k, uint16_t c)
+{
+  if (c == '.' || c == ':') {
+    // Fold into the decimal point of the previous digit
+    if (k > 0 && !(digits[k - 1] & 0b10000000)) {
+      digits[k - 1] |= 0b10000000;
+      return k;
     }
-    setSegments(digits, length, pos);
+    c = 0;
   }
-  else {
-    // Scroll text on display if too long
-    for (int x = 0; x < (MAXDIGITS-1); x++) {  // Scroll message on
-      int y;
-      for (y = 0; y < (MAXDIGITS-1); y++) {
-        // shift left
-        digits[y] = digits[y+1];
-      }
-      digits[y] = encodeASCII(pgm_read_byte(&s[x]));
-      setSegments(digits, length, pos);
-      delay(m_scrollDelay);
+  // A wide glyph takes two digits, other characters use the UTF-8 fallbacks
+  uint8_t glyph[2] = { 0b10000000, 0 };
+  uint8_t width = 1;
+  if (c) {
+    width = TM1637Font::encode(c, glyph);
+    STATS_COUNT(progmemReads, 1);
+  }
+  for (uint8_t i = 0; i < width && k < MAXDIGITS; i++) {
+    digits[k++] = glyph[i];
+  }
+  return k;
+}
+
+void TM1637TinyDisplay6::formatSegments(const char *fmt, va_list args, bool usePROGMEM)
+{
+  uint8_t digits[MAXDIGITS];
+  memset(digits, 0, sizeof(digits));
+  uint8_t k = 0;
+  uint16_t c;
+
+  // Literal text is UTF-8, the conversion specifications are ASCII
+  while ((c = TM1637Font::decodeUTF8(fmt, usePROGMEM)) != 0) {
+    STATS_COUNT(progmemReads, usePROGMEM);
+    if (c != '%') {
+      k = formatChar(digits, k, c);
+      continue;
     }
 
-    for (size_t x = (MAXDIGITS-1); x < strlen_P(s); x++) { // Scroll through string
-      int y;
-      for (y = 0; y < (MAXDIGITS-1); y++) {
-        // shift left
-        digits[y] = digits[y+1];
+    // Flags
+    bool left = false, zero = false;
+    char sign = 0;
+    for (;;) {
+      c = readByte(fmt++, usePROGMEM);
+      if (c == '-') left = true;
+      else if (c == '0') zero = true;
+      else if (c == '+') sign = '+';
+      else if (c == ' ') { if (!sign) sign = ' '; }
+      else break;
+    }
+    // Width and precision (clamped to 99, more than any display can show)
+    uint8_t width = 0;
+    while (c >= '0' && c <= '9') {
+      width = width < 10 ? width * 10 + (c - '0') : 99;
+      c = readByte(fmt++, usePROGMEM);
+    }
+    int8_t precision = -1;
+    if (c == '.') {
+      precision = 0;
+      c = readByte(fmt++, usePROGMEM);
+      while (c >= '0' && c <= '9') {
+        precision = precision < 10 ? precision * 10 + (c - '0') : 99;
+        c = readByte(fmt++, usePROGMEM);
       }
-      digits[y] = encodeASCII(pgm_read_byte(&s[x]));
-      setSegments(digits, length, pos);
-      delay(m_scrollDelay);
     }
-
-    for (int x = 0; x < (MAXDIGITS); x++) {  // Scroll message off
-      int y;
-      for (y = 0; y < (MAXDIGITS-1); y++) {
-        // shift left
-        digits[y] = digits[y+1];
+    bool isLong = false;
+    if (c == 'l') {
+      isLong = true;
+      c = readByte(fmt++, usePROGMEM);
+    }
+    if (c == 0) break;
+
+    // Render the field in reverse into buf (a '.' does not take a digit)
+    char buf[12];
+    uint8_t len = 0, cells = 0, chars = 0;
+    const char *str = nullptr;
+    bool neg = false;
+    unsigned long u = 0;
+    uint8_t base = 10;
+    switch (c) {
+      case 'd':
+      case 'i': {
+        long v = isLong ? va_arg(args, long) : va_arg(args, int);
+        neg = v < 0;
+        u = neg ? 0UL - (unsigned long)v : (unsigned long)v;
+        break;
       }
-      digits[y] = 0;
-      setSegments(digits, length, pos);
-      delay(m_scrollDelay);
+      case 'x':
+      case 'X':
+        base = 16;
+        // fall through
+      case 'u':
+        u = isLong ? va_arg(args, unsigned long) : va_arg(args, unsigned int);
+        break;
+#if TM1637_ENABLE_FLOAT
+      case 'f': {
+        double v = va_arg(args, double);
+        if (precision < 0) precision = 2;
+        // More decimals than this overflow the scaled integer and buf
+        if (precision > FORMAT_MAX_PRECISION) precision = FORMAT_MAX_PRECISION;
+        neg = v < 0;
+        if (neg) v = -v;
+        unsigned long scale = 1;
+        for (int8_t p = 0; p < precision; p++) scale *= 10;
+        double rounded = v * scale + 0.5;
+        unsigned long scaled = rounded < 4294967295.0 ? (unsigned long)rounded : 4294967295UL;
+        for (int8_t p = 0; p < precision && len < sizeof(buf) - 2; p++) {
+          buf[len++] = '0' + scaled % 10;
+          scaled /= 10;
+          STATS_COUNT(divides, 2);
+        }
+        if (precision > 0) buf[len++] = '.';
+        u = scaled;
+        precision = -1;
+        break;
+      }
+#endif
+      case 'c':
+        buf[len++] = (char)va_arg(args, int);
+        precision = 0;
+        break;
+      case 's': {
+        // Count the characters (precision limits them) and the digits they take
+        str = va_arg(args, const char *);
+        const char *p = str;
+        bool fold = false;
+        uint16_t ch;
+        while ((precision < 0 || chars < precision) && (ch = TM1637Font::decodeUTF8(p)) != 0) {
+          chars++;
+          if ((ch == '.' || ch == ':') && fold) {
+            fold = false;
+            continue;
+          }
+          uint8_t glyph[2];
+          cells += TM1637Font::encode(ch, glyph);
+          fold = true;
+        }
+        break;
+      }
+      default:
+        // %% and unknown conversions print the character
+        buf[len++] = c;
+        precision = 0;
+        break;
     }
+    if (str == nullptr && precision != 0) {
+      // Digits of the integer part (at least one)
+      uint8_t start = len;
+      do {
+        uint8_t d = u % base;
+        buf[len++] = d < 10 ? '0' + d : (c == 'x' ? 'a' : 'A') + d - 10;
+        u /= base;
+        STATS_COUNT(divides, 2);
+      } while (u && len < sizeof(buf) - 1);
+      while (precision > 0 && len - start < precision && len < sizeof(buf) - 1) buf[len++] = '0';
+    }
+    if (str == nullptr) {
+      cells = len;
+      for (uint8_t i = 0; i < len; i++) if (buf[i] == '.') cells--;
+    }
+    if (neg) sign = '-';
+    if (sign) cells++;
+
+    // Emit the field with padding
+    uint8_t pad = width > cells ? width - cells : 0;
+    if (!left && !zero) for (; pad; pad--) k = formatChar(digits, k, ' ');
+    if (sign) k = formatChar(digits, k, sign);
+    if (!left && zero) for (; pad; pad--) k = formatChar(digits, k, '0');
+    if (str) {
+      for (uint8_t i = 0; i < chars; i++) k = formatChar(digits, k, TM1637Font::decodeUTF8(str));
+    }
+    else {
+      while (len) k = formatChar(digits, k, (uint8_t)buf[--len]);
+    }
+    for (; pad; pad--) k = formatChar(digits, k, ' ');
+  }
+  setSegments(digits);
+}
+
+#if TM1637_ENABLE_CLOCK
+void TM1637TinyDisplay6::showTime(uint8_t hours, uint8_t minutes, uint8_t seconds, bool blinkColon)
+{
+  m_clock_hours = hours % 24;
+  m_clock_minutes = minutes % 60;
+  m_clock_seconds = seconds % 60;
+  STATS_COUNT(divides, 9);
+  m_clock_blink = blinkColon;
+
+  // Digits of the clock with the points on the DP bit
+  uint8_t colon = (!blinkColon || (m_clock_seconds & 0x01) == 0) ? 0b10000000 : 0;
+  digitsbuf[0] = encodeDigit(m_clock_hours / 10);
+  digitsbuf[1] = encodeDigit(m_clock_hours % 10) | colon;
+  digitsbuf[2] = encodeDigit(m_clock_minutes / 10);
+  digitsbuf[3] = encodeDigit(m_clock_minutes % 10) | colon;
+  digitsbuf[4] = encodeDigit(m_clock_seconds / 10);
+  digitsbuf[5] = encodeDigit(m_clock_seconds % 10);
+  writeChanged();
+}
+
+void TM1637TinyDisplay6::tickTime(unsigned int seconds)
+{
+  // Advance with carry into minutes and hours
+  unsigned long s = m_clock_seconds + (unsigned long)seconds;
+  unsigned long m = m_clock_minutes + s / 60;
+  unsigned long h = m_clock_hours + m / 60;
+  STATS_COUNT(divides, 5);
+  showTime(h % 24, m % 60, s % 60, m_clock_blink);
+}
+#endif
+
+void TM1637TinyDisplay6::writeChanged()
+{
+  uint8_t frame[MAXDIGITS];
+  renderFrame(digitsbuf, frame);
+
+  uint8_t changed = 0;
+  for (uint8_t k=0; k < MAXDIGITS; k++) {
+    if (frame[k] != m_frame[k]) changed++;
+  }
+  if (changed == 0 && m_frameValid) return;
+
+  // Cost in bit delays: each byte takes 30 (3 per bit and up to 6 for the
+  // acknowledge) and each start/stop pair 4. Fixed address mode sends COMM1 and
+  // then address + data in one transaction per digit, while the burst sends
+  // COMM1 and one transaction with the address and all digits.
+  unsigned int fixedCost = (changed + 1) * 4 + (2 * changed + 1) * 30;
+  unsigned int burstCost = 2 * 4 + (MAXDIGITS + 2) * 30;
+
+  // Blinking digits are masked by writeBuffer(), a display that has not been
+  // written since begin() needs every digit and waveform builds send every
+  // update through the compiled waveform of writeBuffer()
+  bool full = !m_frameValid || fixedCost >= burstCost;
+#if TM1637_ENABLE_ANIMATION
+  if (m_blink_digits | m_blink_dots) full = true;
+#endif
+#if TM1637_ENABLE_WAVEFORM
+  full = true;
+#endif
+  if (full) {
+    memcpy(m_frame, frame, MAXDIGITS);
+    writeBuffer();
+    return;
+  }
+
+  // Timed like writeBuffer(), the full update above is timed there
+#if TM1637_ENABLE_STATS
+  TM1637StatsTimer timer(m_stats, STATS_WRITEBUFFER);
+#endif
+
+  // Write COMM1 in fixed address mode
+  start();
+  writeByte(TM1637_I2C_COMM1 | TM1637_FIXED_ADDR);
+  stop();
+
+  // Write COMM2 + address and the data byte of each changed digit
+  for (uint8_t k=0; k < MAXDIGITS; k++) {
+    if (frame[k] == m_frame[k]) continue;
+    m_frame[k] = frame[k];
+    start();
+    writeByte(TM1637_I2C_COMM2 + (digitmap[MAXDIGITS - 1 - k] & 0x07));
+    writeByte(frame[k]);
+    stop();
+  }
+#if TM1637_ENABLE_CAPTURE
+  captureFrame();
+#endif
+}
+
+#if TM1637_ENABLE_TIMER
+void TM1637TinyDisplay6::startTimer(unsigned long ms, void (*callback)())
+{
+  m_timer_duration = ms;
+  m_timer_callback = callback;
+  m_timer_base = 0;
+  m_timer_lap = 0;
+  m_timer_start = nowMs();
+  m_timer_state = TIMER_RUNNING;
+  showTimer();
+}
+
+void TM1637TinyDisplay6::pauseTimer()
+{
+  if (m_timer_state != TIMER_RUNNING) return;
+  m_timer_base += nowMs() - m_timer_start;
+  m_timer_state = TIMER_PAUSED;
+  showTimer();
+}
+
+void TM1637TinyDisplay6::resumeTimer()
+{
+  if (m_timer_state != TIMER_PAUSED) return;
+  m_timer_start = nowMs();
+  m_timer_state = TIMER_RUNNING;
+}
+
+void TM1637TinyDisplay6::stopTimer()
+{
+  pauseTimer();
+  m_timer_state = TIMER_STOPPED;
+}
+
+unsigned long TM1637TinyDisplay6::timerElapsed()
+{
+  unsigned long elapsed = m_timer_base;
+  if (m_timer_state == TIMER_RUNNING) elapsed += nowMs() - m_timer_start;
+  return elapsed;
+}
+
+unsigned long TM1637TinyDisplay6::readTimer()
+{
+  unsigned long elapsed = timerElapsed();
+  if (m_timer_duration == 0) return elapsed;
+  return elapsed >= m_timer_duration ? 0 : m_timer_duration - elapsed;
+}
+
+unsigned long TM1637TinyDisplay6::lapTimer()
+{
+  unsigned long elapsed = timerElapsed();
+  unsigned long lap = elapsed - m_timer_lap;
+  m_timer_lap = elapsed;
+  return lap;
+}
+
+bool TM1637TinyDisplay6::isTimerRunning()
+{
+  return m_timer_state == TIMER_RUNNING;
+}
+
+unsigned long TM1637TinyDisplay6::timerUnit(unsigned long ms)
+{
+  // Resolution of the format used for a time
+  if (ms < 3600000UL) return 10;        // mm.ss.hh
+  return 1000;                          // hh.mm.ss
+}
+
+void TM1637TinyDisplay6::showTimer()
+{
+  unsigned long ms = readTimer();
+  unsigned long unit = timerUnit(ms);
+
+  // A countdown rounds up so it shows zero only when the time is over
+  unsigned long t = (m_timer_duration ? ms + unit - 1 : ms) / unit;
+  STATS_COUNT(divides, 1);
+  if (unit != timerUnit(t * unit)) {
+    unit = timerUnit(t * unit);
+    t = (m_timer_duration ? ms + unit - 1 : ms) / unit;
+    STATS_COUNT(divides, 1);
+  }
+
+  // Split into three pairs of digits with points on the DP bits
+  unsigned long pairs[3];
+  if (unit == 10) {
+    pairs[2] = t % 100;
+    t /= 100;
+  }
+  else {
+    pairs[2] = t % 60;
+    t /= 60;
+  }
+  pairs[1] = t % 60;
+  pairs[0] = (t / 60) % 100;
+  for (uint8_t i = 0; i < 3; i++) {
+    digitsbuf[2 * i] = encodeDigit(pairs[i] / 10);
+    digitsbuf[2 * i + 1] = encodeDigit(pairs[i] % 10) | (i < 2 ? 0b10000000 : 0);
   }
+  STATS_COUNT(divides, 11);
+  writeChanged();
 }
 
+void TM1637TinyDisplay6::updateTimer()
+{
+  showTimer();
+  if (m_timer_duration && timerElapsed() >= m_timer_duration) {
+    // Countdown is over
+    m_timer_base = m_timer_duration;
+    m_timer_state = TIMER_STOPPED;
+    if (m_timer_callback) m_timer_callback();
+  }
+}
+#endif
+
 void TM1637TinyDisplay6::showLevel(unsigned int level, bool horizontal) 
 {
   // digits[MAXDIGITS] output array to render
+  uint8_t digits[MAXDIGITS];
   memset(digits,0,sizeof(digits));
 
   uint8_t digit = 0b00000000;
@@ -542,7 +1276,8 @@ void TM1637TinyDisplay6::showLevel(unsigned int level, bool horizontal)
 
   if(horizontal) {
     // Must fit within 3 bars
-    int bars = (int)((level*3)/100.0);
+    int bars = (level*3)/100;
+    STATS_COUNT(divides, 1);
     if(bars == 0 && level > 0) bars = 1; // Only level=0 turns off display
     switch(bars) {
       case 1:
@@ -563,7 +1298,8 @@ void TM1637TinyDisplay6::showLevel(unsigned int level, bool horizontal)
   }
   else {
     // Must fit within (MAXDIGITS * 2) bars
-    int bars = (int)((level*(MAXDIGITS*2))/100.0);
+    int bars = (level*(MAXDIGITS*2))/100;
+    STATS_COUNT(divides, 1);
     if(bars == 0 && level > 0) bars = 1;
     for(int x = 0; x<MAXDIGITS; x++) { // for each digit
       int left = bars-(x*2);
@@ -574,32 +1310,202 @@ void TM1637TinyDisplay6::showLevel(unsigned int level, bool horizontal)
   setSegments(digits);
 }
 
+#if TM1637_ENABLE_METER
+void TM1637TinyDisplay6::startMeter(int range, uint8_t mode, uint8_t tickMs)
+{
+  m_meter_range = range > 0 ? range : 1;
+  m_meter_mode = mode | METER_ACTIVE;
+  m_meter_ms = tickMs ? tickMs : 1;
+  m_meter_level = 0;
+  m_meter_input = 0;
+  m_meter_peak = 0;
+  m_meter_new = false;
+  m_meter_tick = nowMs();
+  m_meter_peak_start = m_meter_tick;
+  showMeter();
+}
+
+void TM1637TinyDisplay6::setMeterDynamics(uint8_t attack, uint8_t decay, unsigned int peakHoldMs)
+{
+  m_meter_attack = attack;
+  m_meter_decay = decay;
+  m_meter_hold = peakHoldMs;
+}
+
+void TM1637TinyDisplay6::meterSample(int sample)
+{
+  // Samples are ignored until startMeter()
+  if (!(m_meter_mode & METER_ACTIVE)) return;
+
+  // Scale to bars in 8.8 fixed point
+  int8_t bars = (m_meter_mode & METER_CENTER) ? MAXDIGITS : meterBars();
+  if (sample > m_meter_range) sample = m_meter_range;
+  if (sample < -m_meter_range) sample = -m_meter_range;
+  if (!(m_meter_mode & METER_CENTER) && sample < 0) sample = 0;
+  int level = (int)(((long)sample * (bars << 8)) / m_meter_range);
+  STATS_COUNT(divides, 1);
+
+  // Keep the largest sample of this tick
+  if (!m_meter_new || abs(level) > abs(m_meter_input)) m_meter_input = level;
+  m_meter_new = true;
+}
+
+void TM1637TinyDisplay6::stopMeter()
+{
+  m_meter_mode &= ~METER_ACTIVE;
+}
+
+int8_t TM1637TinyDisplay6::meterBars()
+{
+  // Bars on the display: 3 lines per digit or 2 vertical bars per digit
+  return (m_meter_mode & METER_STACK) ? 3 : MAXDIGITS * 2;
+}
+
+int8_t TM1637TinyDisplay6::meterLit()
+{
+  // Lit bars, rounded so only a zero level is dark
+  int8_t lit = m_meter_level / 256;
+  STATS_COUNT(divides, 1);
+  if (lit == 0 && m_meter_level > 0) lit = 1;
+  if (lit == 0 && m_meter_level < 0) lit = -1;
+  return lit;
+}
+
+void TM1637TinyDisplay6::updateMeter()
+{
+  uint32_t now = nowMs();
+  if (now - m_meter_tick < m_meter_ms) return;
+
+  // Catch up on missed ticks so the dynamics follow time, not the Animate() rate
+  uint8_t ticks = 0;
+  while (now - m_meter_tick >= m_meter_ms && ticks < 255) {
+    m_meter_tick += m_meter_ms;
+    ticks++;
+  }
+  if (now - m_meter_tick >= m_meter_ms) m_meter_tick = now;
+
+  int target = m_meter_input;
+  m_meter_new = false;
+  uint8_t elapsed = ticks;
+  while (ticks--) {
+    int diff = target - m_meter_level;
+    if (diff == 0) break;
+    uint8_t rate = abs(target) > abs(m_meter_level) ? m_meter_attack : m_meter_decay;
+    int step = rate ? (int)(((long)diff * rate) >> 8) : diff;
+    if (step == 0) step = diff > 0 ? 1 : -1;
+    m_meter_level += step;
+  }
+
+  int8_t lit = meterLit();
+
+  // Peak marker follows a new high and falls one bar per tick after the hold time,
+  // counting the ticks that passed since the previous update
+  if (abs(lit) >= abs(m_meter_peak) || (lit != 0 && (lit > 0) != (m_meter_peak > 0))) {
+    m_meter_peak = lit;
+    m_meter_peak_start = now;
+  }
+  else if (now - m_meter_peak_start >= m_meter_hold) {
+    unsigned long due = (now - m_meter_peak_start - m_meter_hold) / m_meter_ms + 1;
+    STATS_COUNT(divides, 1);
+    uint8_t fall = due < elapsed ? due : elapsed;
+    while (fall-- && abs(m_meter_peak) > abs(lit)) {
+      m_meter_peak += m_meter_peak > 0 ? -1 : 1;
+    }
+  }
+  showMeter();
+}
+
+void TM1637TinyDisplay6::showMeter()
+{
+  int8_t lit = meterLit();
+  int8_t peak = (m_meter_mode & METER_PEAK) ? m_meter_peak : 0;
+
+  memset(digitsbuf, 0, sizeof(digitsbuf));
+  if (m_meter_mode & METER_STACK) {
+    // Lines from the bottom up on every digit
+    static const uint8_t lines[3] = { 0b00001000, 0b01000000, 0b00000001 };
+    uint8_t digit = 0;
+    for (int8_t i = 0; i < 3; i++) {
+      if (i < lit || i == peak - 1) digit |= lines[i];
+    }
+    memset(digitsbuf, digit, sizeof(digitsbuf));
+  }
+  else {
+    // Bars from left to right, two per digit - a centre-zero meter grows from
+    // the middle to the right for positive and to the left for negative levels
+    int8_t bars = meterBars();
+    int8_t zero = (m_meter_mode & METER_CENTER) ? MAXDIGITS : 0;
+    for (int8_t i = 0; i < bars; i++) {
+      int8_t pos = i - zero;
+      bool on = (lit > 0 && pos >= 0 && pos < lit) || (lit < 0 && pos < 0 && pos >= lit) ||
+        (peak > 0 && pos == peak - 1) || (peak < 0 && pos == peak);
+      if (on) digitsbuf[i / 2] |= (i & 1) ? 0b00000110 : 0b00110000;
+    }
+  }
+  writeChanged();
+}
+#endif
+
+#if TM1637_ENABLE_ANIMATION
 bool TM1637TinyDisplay6::Animate(bool loop)
 {
+#if TM1637_ENABLE_STATS
+    TM1637StatsTimer timer(m_stats, STATS_ANIMATE);
+#endif
+    // toggle blinking digits when the blink phase changes
+    if (m_blink_digits | m_blink_dots) {
+      unsigned long periods = (nowMs() - m_blink_start) / m_blink_ms;
+      STATS_COUNT(divides, 1);
+      if (periods > 0) {
+        // advance by whole periods so the blink does not drift
+        m_blink_start += periods * m_blink_ms;
+        if (periods & 0x01) {
+          m_blink_state ^= 0x01;
+          writeBuffer();
+        }
+      }
+    }
+
+#if TM1637_ENABLE_TIMER
+    // refresh the countdown/stopwatch digits
+    if (m_timer_state == TIMER_RUNNING) updateTimer();
+#endif
+
+#if TM1637_ENABLE_METER
+    // advance the level meter
+    if (m_meter_mode & METER_ACTIVE) updateMeter();
+#endif
+
     // return if no animation/scroll is running
     if (m_animation_type == 0) return false;
 
-    unsigned int frame_num = (millis() - m_animation_start) / m_animation_frame_ms;
+    unsigned long elapsed = nowMs() - m_animation_start;
+    unsigned long period = (unsigned long)m_animation_frames * m_animation_frame_ms;
 
     // we have run past our max frame (this can happen because of frame dropping)
-    if (frame_num >= m_animation_frames) {
-      if (loop) {
-        // restart
-        m_animation_start = millis();
-        frame_num = 0;
+    if (elapsed >= period) {
+      if (loop && period > 0) {
+        // restart on the frame grid (start + N * period) so looping does not drift
+        m_animation_start += (elapsed / period) * period;
+        elapsed = elapsed % period;
+        STATS_COUNT(divides, 2);
       } else {
         m_animation_type = 0;
         return false;
       }
     }
+    unsigned int frame_num = elapsed / m_animation_frame_ms;
+    STATS_COUNT(divides, 1);
 
     // bail out if the animation frame has not changed
-    if (frame_num == m_animation_last_frame) {
+    unsigned int last_frame = m_animation_last_frame;
+    if (frame_num == last_frame) {
         return true;
     } else {
         m_animation_last_frame = frame_num;
     }
 
+    uint8_t digits[MAXDIGITS];
     memset(digits, 0, sizeof(digits));
     switch(m_animation_type) {
         case 1: // regular animation running
@@ -610,36 +1516,138 @@ bool TM1637TinyDisplay6::Animate(bool loop)
             break;
         case 2: // PROGMEM animation running
             for(unsigned int a = 0; a < MAXDIGITS; a++) {
-                digits[a] = pgm_read_byte(&(m_animation_sequence[frame_num][a]));
+                digits[a] = readByte(&(m_animation_sequence[frame_num][a]), true);
             }
             setSegments(digits, MAXDIGITS, 0);
             break;
+#if TM1637_ENABLE_SCROLL
         case 3: // PROGMEM text scroll running
-            for (int x = 0; x < MAXDIGITS; x++) {
-                int offset = frame_num - MAXDIGITS + x;
-                if (offset >= 0 && offset < (int)(m_animation_frames - (2 * MAXDIGITS))) {
-                    digits[x] = encodeASCII(pgm_read_byte(&m_animation_string[offset]));
-                } else {
-                    digits[x] = 0;
-                }
-            }
-            setSegments(digits, MAXDIGITS, 0);
-            break;
         case 4: // SRAM text scroll running
-            for (int x = 0; x < MAXDIGITS; x++) {
-                int offset = frame_num - MAXDIGITS + x;
-                if (offset >= 0 && offset < (int)(m_animation_frames - (2 * MAXDIGITS))) {
-                    digits[x] = encodeASCII(m_animation_string[offset]);
-                } else {
-                    digits[x] = 0;
-                }
-            }
-            setSegments(digits, MAXDIGITS, 0);
+        case 5: // text scroll from a source running
+            scrollFrames(frame_num, last_frame);
             break;
+#endif
     }
     return true;
 }
 
+#if TM1637_ENABLE_SCROLL
+void TM1637TinyDisplay6::scrollFrames(unsigned int frame, unsigned int last)
+{
+    uint8_t digits[MAXDIGITS];
+    if (last == (unsigned int)-1 || frame < last) {
+        // (re)start from the empty frame 0 - a source continues where it is
+        memset(digits, 0, sizeof(digits));
+        if (m_animation_type != 5) m_scroll_next = (const char *) m_animation_string;
+        m_animation_frames = SCROLL_UNKNOWN_FRAMES;
+        last = 0;
+    } else {
+        memcpy(digits, digitsbuf, sizeof(digits));
+    }
+
+    // shift in one character per frame (more if frames were dropped)
+    for (; last < frame; last++) {
+        uint16_t c = 0;
+        if (m_animation_frames == SCROLL_UNKNOWN_FRAMES) {
+            c = scrollChar();
+            if (c == SCROLL_WAIT) {
+                // hold this frame until the source has a character
+                m_animation_start = nowMs() - (unsigned long)last * m_animation_frame_ms;
+                m_animation_last_frame = last;
+                break;
+            }
+            if (c == 0) {
+                // end of the text - the scroll ends MAXDIGITS * 2 frames later (length
+                // + MAXDIGITS * 2 in total): the text has left the display after
+                // MAXDIGITS frames and the blank display is held for the rest
+                m_animation_frames = last + (MAXDIGITS * 2);
+            }
+        }
+        for (uint8_t y = 0; y < (MAXDIGITS-1); y++) {
+            digits[y] = digits[y+1];
+        }
+        digits[MAXDIGITS-1] = c ? TM1637Font::encodeCodepoint(c) : 0;
+        if (c) STATS_COUNT(progmemReads, 1 + (m_animation_type == 3));
+    }
+
+    // restart the frame count of a long scroll so it never runs out
+    if (m_animation_frames == SCROLL_UNKNOWN_FRAMES && last >= SCROLL_REBASE_FRAMES) {
+        m_animation_start += (unsigned long)last * m_animation_frame_ms;
+        m_animation_last_frame = 0;
+    }
+    setSegments(digits);
+}
+
+uint16_t TM1637TinyDisplay6::scrollChar()
+{
+    if (m_animation_type != 5) {
+        return TM1637Font::decodeUTF8(m_scroll_next, m_animation_type == 3);
+    }
+
+    // pull bytes until a character is complete
+    for (;;) {
+        int b = m_scroll_peek;
+        m_scroll_peek = SOURCE_WAIT;
+        if (b == SOURCE_WAIT) b = m_scroll_source(m_scroll_context);
+        if (b == SOURCE_WAIT) return SCROLL_WAIT;
+        if (b < 0 || b == 0) return 0;
+
+        bool again;
+        uint16_t c = m_scroll_utf8.decode(b, again);
+        if (again) m_scroll_peek = b;
+        if (c) return c;
+    }
+}
+#endif
+
+unsigned long TM1637TinyDisplay6::nextDeadlineMs()
+{
+    unsigned long deadline = NO_DEADLINE;
+    uint32_t now = nowMs();
+
+    // next blink phase change
+    if (m_blink_digits | m_blink_dots) {
+      unsigned long elapsed = now - m_blink_start;
+      deadline = (elapsed >= m_blink_ms) ? 0 : m_blink_ms - elapsed;
+    }
+
+#if TM1637_ENABLE_TIMER
+    // next change of the countdown/stopwatch digits
+    if (m_timer_state == TIMER_RUNNING) {
+      unsigned long ms = readTimer();
+      unsigned long next;
+      if (m_timer_duration) {
+        // a countdown shows the next value (or zero) once ms drops below a unit
+        next = ms ? (ms - 1) % timerUnit(ms - 1) + 1 : 0;
+      }
+      else {
+        next = timerUnit(ms) - ms % timerUnit(ms);
+      }
+      if (next < deadline) deadline = next;
+    }
+#endif
+
+#if TM1637_ENABLE_METER
+    // next level meter tick
+    if (m_meter_mode & METER_ACTIVE) {
+      unsigned long elapsed = nowMs() - m_meter_tick;
+      unsigned long next = elapsed < m_meter_ms ? m_meter_ms - elapsed : 0;
+      if (next < deadline) deadline = next;
+    }
+#endif
+
+    // next animation frame (or end of the animation)
+    if (m_animation_type != 0) {
+      unsigned long elapsed = now - m_animation_start;
+      unsigned long next = 0;
+      if (elapsed / m_animation_frame_ms == m_animation_last_frame) {
+        next = m_animation_frame_ms - (elapsed % m_animation_frame_ms);
+      }
+      if (next < deadline) deadline = next;
+    }
+    return deadline;
+}
+
 void TM1637TinyDisplay6::startAnimation_P(const uint8_t(*data)[MAXDIGITS], unsigned int frames, unsigned int ms)
 {
     startAnimation(data, frames, ms, true);
@@ -652,11 +1660,11 @@ void TM1637TinyDisplay6::startAnimation(const uint8_t (*data)[MAXDIGITS], unsign
     } else {
         m_animation_type = 1;
     }
-    m_animation_start = millis() ;
+    m_animation_start = nowMs();
+    m_animation_last_frame = (unsigned int)-1;
     m_animation_frames = frames;
     m_animation_frame_ms = ms;
     m_animation_sequence = (uint8_t (*)[MAXDIGITS]) data;
-    m_animation_string = nullptr;
 }
 
 void TM1637TinyDisplay6::stopAnimation()
@@ -664,39 +1672,70 @@ void TM1637TinyDisplay6::stopAnimation()
     m_animation_type = 0;
 }
 
+void TM1637TinyDisplay6::setBlink(uint8_t digits, uint8_t dots, unsigned int ms, uint8_t phase)
+{
+    m_blink_digits = digits;
+    m_blink_dots = dots;
+    m_blink_phase = phase;
+    m_blink_ms = ms ? ms : 1;
+    m_blink_state = 0;
+    m_blink_start = nowMs();
+    writeBuffer();
+}
+
+void TM1637TinyDisplay6::stopBlink()
+{
+    setBlink(0);
+}
+
+#if TM1637_ENABLE_SCROLL
 void TM1637TinyDisplay6::startStringScroll_P(const char s[], unsigned int ms)
 {
     startStringScroll(s, ms, true);
 }
 
 void TM1637TinyDisplay6::startStringScroll(const char s[], unsigned int ms, bool usePROGMEM) {
-    if (usePROGMEM) {
-        m_animation_frames = strlen_P(s);
-        if (m_animation_frames <= MAXDIGITS) {
-            // no need to scroll, just display it
-            showString_P(s, m_animation_frames, 0, 0);
-            return;
-        } else {
-            m_animation_type = 3;
-        }
-    } else {
-        m_animation_frames = strlen(s);
-        if (m_animation_frames <= MAXDIGITS) {
-            // no need to scroll, just display it
-            showString(s, m_animation_frames, 0, 0);
-            return;
-        } else {
-            m_animation_type = 4;
-        }
+    // count characters only as far as needed to know if the text scrolls
+    const char *p = s;
+    uint8_t count = 0;
+    while (count <= MAXDIGITS && TM1637Font::decodeUTF8(p, usePROGMEM) != 0) count++;
+    if (count <= MAXDIGITS) {
+        // no need to scroll, just display it (like showString())
+        renderString(s, MAXDIGITS, 0, 0, usePROGMEM);
+        return;
     }
-    // add scroll on/off frames to the total animation frame count
-    m_animation_frames = m_animation_frames + (MAXDIGITS * 2);
+    m_animation_type = usePROGMEM ? 3 : 4;
+
+    // the frame count (length plus scroll on/off frames) is set by Animate()
+    // when it reaches the end of the text
+    m_animation_frames = SCROLL_UNKNOWN_FRAMES;
 
-    m_animation_start = millis();
+    m_animation_start = nowMs();
+    m_animation_last_frame = (unsigned int)-1;
     m_animation_frame_ms = ms;
-    m_animation_sequence = nullptr;
     m_animation_string = (uint8_t *) s;
+    m_scroll_next = s;
+}
+
+void TM1637TinyDisplay6::startSourceScroll(int (*source)(void *context), void *context, unsigned int ms)
+{
+    m_animation_type = 5;
+    m_animation_frames = SCROLL_UNKNOWN_FRAMES;
+    m_animation_start = nowMs();
+    m_animation_last_frame = (unsigned int)-1;
+    m_animation_frame_ms = ms;
+    m_scroll_source = source;
+    m_scroll_context = context;
+    m_scroll_peek = SOURCE_WAIT;
+    m_scroll_utf8.reset();
+}
+
+void TM1637TinyDisplay6::startStreamScroll(Stream &stream, unsigned int ms, bool live)
+{
+    startSourceScroll(live ? readStreamLive : readStream, &stream, ms);
 }
+#endif
+#endif
 
 
 
@@ -705,7 +1744,7 @@ void TM1637TinyDisplay6::showAnimation(const uint8_t data[][6], unsigned int fra
   // Animation sequence
   for (unsigned int x = 0; x < frames; x++) {
     setSegments(data[x],6,0);
-    delay(ms);
+    waitMs(ms);
   }
 }
 
@@ -715,26 +1754,63 @@ void TM1637TinyDisplay6::showAnimation_P(const uint8_t data[][6], unsigned int f
   uint8_t digits[6] = {0,0,0,0,0,0};
   for (unsigned int x = 0; x < frames; x++) {
     for(unsigned int a = 0; a < 6; a++) {
-          digits[a] = pgm_read_byte(&(data[x][a]));
+          digits[a] = readByte(&(data[x][a]), true);
     }
     setSegments(digits,6,0);
-    delay(ms);
+    waitMs(ms);
   }
 }
 
 void TM1637TinyDisplay6::bitDelay()
 {
+#if TM1637_ENABLE_STATS
+  m_stats.bitDelays++;
+  m_stats.delayUs += m_bitDelay;
+#endif
   delayMicroseconds(m_bitDelay);
 }
 
 void TM1637TinyDisplay6::start()
 {
+#if TM1637_ENABLE_STATS
+  m_stats.transactions++;
+#endif
+#if TM1637_FIXED_PINS
+  if (m_pinClk == TM1637_CLK_PIN && m_pinDIO == TM1637_DIO_PIN) {
+    FixedPins::start(m_bitDelay);
+    return;
+  }
+#endif
+#if TM1637_ENABLE_USI
+  if (m_transport == TRANSPORT_USI) {
+    TM1637USI::start(m_bitDelay);
+    return;
+  }
+#endif
+#if TM1637_ENABLE_STATS
+  m_stats.pinAccesses++;
+#endif
   pinMode(m_pinDIO, OUTPUT);
   bitDelay();
 }
 
 void TM1637TinyDisplay6::stop()
 {
+#if TM1637_FIXED_PINS
+  if (m_pinClk == TM1637_CLK_PIN && m_pinDIO == TM1637_DIO_PIN) {
+    FixedPins::stop(m_bitDelay);
+    return;
+  }
+#endif
+#if TM1637_ENABLE_USI
+  if (m_transport == TRANSPORT_USI) {
+    TM1637USI::stop(m_bitDelay);
+    return;
+  }
+#endif
+#if TM1637_ENABLE_STATS
+  m_stats.pinAccesses += 3;
+#endif
   pinMode(m_pinDIO, OUTPUT);
   bitDelay();
   pinMode(m_pinClk, INPUT);
@@ -745,6 +1821,19 @@ void TM1637TinyDisplay6::stop()
 
 bool TM1637TinyDisplay6::writeByte(uint8_t b)
 {
+#if TM1637_ENABLE_STATS
+  m_stats.bytes++;
+#endif
+#if TM1637_FIXED_PINS
+  if (m_pinClk == TM1637_CLK_PIN && m_pinDIO == TM1637_DIO_PIN) {
+    return FixedPins::writeByte(b, m_bitDelay);
+  }
+#endif
+#if TM1637_ENABLE_USI
+  if (m_transport == TRANSPORT_USI) {
+    return TM1637USI::writeByte(b, m_bitDelay);
+  }
+#endif
   uint8_t data = b;
 
   // 8 Data Bits
@@ -783,6 +1872,10 @@ bool TM1637TinyDisplay6::writeByte(uint8_t b)
   bitDelay();
   pinMode(m_pinClk, OUTPUT);
   bitDelay();
+#if TM1637_ENABLE_STATS
+  // 3 per bit, 5 for the acknowledge and one more if the display pulled DIO low
+  m_stats.pinAccesses += 29 + (ack == 0);
+#endif
 
   return ack;
 }
@@ -798,14 +1891,19 @@ void TM1637TinyDisplay6::showDots(uint8_t dots, uint8_t* digits)
 
 uint8_t TM1637TinyDisplay6::encodeDigit(uint8_t digit)
 {
-  // return digitToSegment[digit & 0x0f] using PROGMEM
-  return pgm_read_byte(digitToSegment + (digit & 0x0f));
+  STATS_COUNT(progmemReads, 1);
+  return TM1637Font::encodeDigit(digit);
 }
 
 uint8_t TM1637TinyDisplay6::encodeASCII(uint8_t chr)
 {
-  if(chr == 176) return degreeSegments;   // Degree mark
-  if(chr > 127 || chr < 32) return 0;     // Blank
-  // return asciiToSegment[chr - 32] using PROGMEM
-  return pgm_read_byte(asciiToSegment + (chr - 32));
+  STATS_COUNT(progmemReads, 1);
+  return TM1637Font::encodeASCII(chr);
+}
+
+uint8_t TM1637TinyDisplay6::readByte(const void *p, bool usePROGMEM)
+{
+  if (!usePROGMEM) return *(const uint8_t *)p;
+  STATS_COUNT(progmemReads, 1);
+  return pgm_read_byte(p);
 }
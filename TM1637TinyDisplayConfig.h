@@ -0,0 +1,140 @@
+//  TM1637 Tiny Display
+//  Compile-time feature configuration for TM1637TinyDisplay and TM1637TinyDisplay6
+//
+//  Author: Jason A. Cox - @jasonacox - https://github.com/jasonacox
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2.1 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+
+#ifndef __TM1637TINYDISPLAYCONFIG__
+#define __TM1637TINYDISPLAYCONFIG__
+
+// Feature Configuration
+//
+// Each feature can be turned off by setting it to 0, either by editing this file
+// or with a compiler flag (e.g. PlatformIO build_flags = -DTM1637_ENABLE_FLOAT=0).
+// A disabled feature removes its functions from the class and its members from
+// every display object, which matters on small controllers like the ATtiny85.
+//
+// TM1637_ENABLE_ANIMATION - Non-blocking Animate(), startAnimation(), setBlink()
+// TM1637_ENABLE_SCROLL    - Scrolling of strings longer than the display
+//                           (startStringScroll() also requires ANIMATION)
+// TM1637_ENABLE_FLOAT     - showNumber(double) (avoids linking floating point math)
+// TM1637_ENABLE_FLIP      - flipDisplay() and setOrientation() (upside down and mirrored)
+// TM1637_ENABLE_TIMER     - startTimer() countdown/stopwatch driven by Animate() (defaults
+//                           to ANIMATION, adds the timer state to each display object)
+// TM1637_ENABLE_METER     - startMeter() level meter with peak hold driven by Animate()
+//                           (off by default, adds the meter state to each display object)
+// TM1637_ENABLE_FULL_FONT - 256 entry ASCII map so encodeASCII() is a single lookup without
+//                           range checks (off by default, 160 more table entries in flash)
+// TM1637_ENABLE_GLYPHS    - TM1637Font::addGlyphs() custom glyph tables (adds the table
+//                           pointers once, not per display, and a pointer test to encodeASCII())
+// TM1637_ENABLE_CLOCK     - showTime() and tickTime() clock display
+// TM1637_ENABLE_WAVEFORM  - writeBuffer() compiles each update into a TM1637Waveform and
+//                           replays it with fixed timing (off by default, uses a
+//                           TM1637Waveform on the stack during each update)
+// TM1637_ENABLE_USI       - TRANSPORT_USI constructor option to shift bytes with the USI
+//                           peripheral (on by default on ATtiny25/45/85 and ATtiny24/44/84,
+//                           adds one byte to each display object)
+// TM1637_ENABLE_STATS     - getStats() with call counts, bytes, blocked time and a latency
+//                           histogram (off by default, adds the counters to each display
+//                           object and no code when off)
+// TM1637_CLK_PIN and TM1637_DIO_PIN - Pins of a display with fixed wiring (not defined
+//                           by default). Set them for the whole build (e.g. PlatformIO
+//                           build_flags), not in the sketch. A display constructed on these
+//                           pins uses TM1637Pins with the pins as constants; displays on
+//                           other pins use pinMode() as before. No RAM is added.
+// TM1637_ENABLE_CAPTURE   - setCapture() records every frame and brightness change into a
+//                           TM1637Capture ring buffer for export to the animator (off by
+//                           default, adds a pointer to each display object)
+// TM1637_ENABLE_TIME_SOURCE - setTimeSource() to take time from a TM1637TimeSource instead
+//                           of millis() and delay(), e.g. a virtual clock for tests (off
+//                           by default, adds a pointer to each display object)
+//
+// The examples/TM1637-Footprint sketch prints sizeof() of the display class and the
+// features of the build it was compiled with; the IDE (or avr-size) reports the
+// flash used by the same build.
+
+#ifndef TM1637_ENABLE_ANIMATION
+#define TM1637_ENABLE_ANIMATION   1
+#endif
+
+#ifndef TM1637_ENABLE_SCROLL
+#define TM1637_ENABLE_SCROLL      1
+#endif
+
+#ifndef TM1637_ENABLE_FLOAT
+#define TM1637_ENABLE_FLOAT       1
+#endif
+
+#ifndef TM1637_ENABLE_FLIP
+#define TM1637_ENABLE_FLIP        1
+#endif
+
+#ifndef TM1637_ENABLE_TIMER
+#define TM1637_ENABLE_TIMER       TM1637_ENABLE_ANIMATION
+#endif
+#if TM1637_ENABLE_TIMER && !TM1637_ENABLE_ANIMATION
+#error "TM1637_ENABLE_TIMER requires TM1637_ENABLE_ANIMATION=1"
+#endif
+
+#ifndef TM1637_ENABLE_METER
+#define TM1637_ENABLE_METER       0
+#endif
+#if TM1637_ENABLE_METER && !TM1637_ENABLE_ANIMATION
+#error "TM1637_ENABLE_METER requires TM1637_ENABLE_ANIMATION=1"
+#endif
+
+#ifndef TM1637_ENABLE_FULL_FONT
+#define TM1637_ENABLE_FULL_FONT   0
+#endif
+
+#ifndef TM1637_ENABLE_GLYPHS
+#define TM1637_ENABLE_GLYPHS      1
+#endif
+
+#ifndef TM1637_ENABLE_CLOCK
+#define TM1637_ENABLE_CLOCK       1
+#endif
+
+#ifndef TM1637_ENABLE_WAVEFORM
+#define TM1637_ENABLE_WAVEFORM    0
+#endif
+
+#ifndef TM1637_ENABLE_USI
+#if defined(__AVR_ATtiny25__) || defined(__AVR_ATtiny45__) || defined(__AVR_ATtiny85__) || \
+    defined(__AVR_ATtiny24__) || defined(__AVR_ATtiny44__) || defined(__AVR_ATtiny84__)
+#define TM1637_ENABLE_USI         1
+#else
+#define TM1637_ENABLE_USI         0
+#endif
+#endif
+
+#ifndef TM1637_ENABLE_STATS
+#define TM1637_ENABLE_STATS       0
+#endif
+
+#if defined(TM1637_CLK_PIN) && defined(TM1637_DIO_PIN)
+#define TM1637_FIXED_PINS         1
+#elif defined(TM1637_CLK_PIN) || defined(TM1637_DIO_PIN)
+#error "TM1637_CLK_PIN and TM1637_DIO_PIN must be defined together"
+#else
+#define TM1637_FIXED_PINS         0
+#endif
+
+#ifndef TM1637_ENABLE_CAPTURE
+#define TM1637_ENABLE_CAPTURE     0
+#endif
+
+#ifndef TM1637_ENABLE_TIME_SOURCE
+#define TM1637_ENABLE_TIME_SOURCE 0
+#endif
+
+#endif // __TM1637TINYDISPLAYCONFIG__
@@ -0,0 +1,103 @@
+//  TM1637 Tiny Display
+//  USI hardware transport for ATtiny controllers
+//
+//  Author: Jason A. Cox - @jasonacox - https://github.com/jasonacox
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2.1 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+
+#include <TM1637USI.h>
+
+#if TM1637_ENABLE_USI
+
+#include <Arduino.h>
+
+// Two-wire mode, shift on external positive edge, count software clock strobes
+#define USI_CR_TWI  ((1 << USIWM1) | (1 << USICS1) | (1 << USICLK))
+// Clear all flags and preset the 4-bit edge counter
+#define USI_SR_CLEAR  ((1 << USISIF) | (1 << USIOIF) | (1 << USIPF) | (1 << USIDC))
+
+bool TM1637USI::begin(uint8_t pinClk, uint8_t pinDIO)
+{
+  return portOutputRegister(digitalPinToPort(pinClk)) == &USI_PORT &&
+    digitalPinToBitMask(pinClk) == (1 << USI_SCL) &&
+    portOutputRegister(digitalPinToPort(pinDIO)) == &USI_PORT &&
+    digitalPinToBitMask(pinDIO) == (1 << USI_SDA);
+}
+
+void TM1637USI::start(unsigned int bitDelay)
+{
+  // Release both lines (open drain) and hand them to the USI
+  USI_PORT |= (1 << USI_SDA) | (1 << USI_SCL);
+  USIDR = 0xFF;
+  USICR = USI_CR_TWI;
+  USISR = USI_SR_CLEAR;
+  USI_DDR |= (1 << USI_SDA) | (1 << USI_SCL);
+
+  // DIO low while CLK is high
+  USI_PORT &= ~(1 << USI_SDA);
+  delayMicroseconds(bitDelay);
+}
+
+void TM1637USI::stop(unsigned int bitDelay)
+{
+  // DIO low, CLK high then DIO high
+  USIDR = 0xFF;
+  USI_PORT &= ~(1 << USI_SDA);
+  delayMicroseconds(bitDelay);
+  USI_PORT |= (1 << USI_SCL);
+  delayMicroseconds(bitDelay);
+  USI_PORT |= (1 << USI_SDA);
+  delayMicroseconds(bitDelay);
+
+  // Back to inputs - the pull-ups keep the lines high until the USI is off
+  USI_DDR &= ~((1 << USI_SDA) | (1 << USI_SCL));
+  USICR = 0;
+  USI_PORT &= ~((1 << USI_SDA) | (1 << USI_SCL));
+}
+
+void TM1637USI::clock(uint8_t edges, unsigned int bitDelay)
+{
+  // Each USITC strobe toggles SCL and counts one edge until the counter overflows
+  USISR = USI_SR_CLEAR | (16 - edges);
+  do {
+    delayMicroseconds(bitDelay);
+    USICR = USI_CR_TWI | (1 << USITC);
+  } while (!(USISR & (1 << USIOIF)));
+  delayMicroseconds(bitDelay);
+}
+
+bool TM1637USI::writeByte(uint8_t b, unsigned int bitDelay)
+{
+  // CLK low before the data changes
+  USI_PORT &= ~(1 << USI_SCL);
+
+  // Reverse the bits - USI shifts MSB first, the TM1637 expects LSB first
+  b = (b & 0xF0) >> 4 | (b & 0x0F) << 4;
+  b = (b & 0xCC) >> 2 | (b & 0x33) << 2;
+  b = (b & 0xAA) >> 1 | (b & 0x55) << 1;
+  USIDR = b;
+  USI_PORT |= (1 << USI_SDA);
+
+  // 8 Data Bits
+  clock(16, bitDelay);
+
+  // Wait for acknowledge - release DIO and clock once
+  USI_DDR &= ~(1 << USI_SDA);
+  USIDR = 0xFF;
+  clock(2, bitDelay);
+  uint8_t ack = USIDR & 0x01;
+  USIDR = 0xFF;
+  USI_DDR |= (1 << USI_SDA);
+
+  return ack;
+}
+
+#endif // TM1637_ENABLE_USI
@@ -0,0 +1,70 @@
+//  TM1637 Tiny Display
+//  USI hardware transport for ATtiny controllers
+//
+//  Author: Jason A. Cox - @jasonacox - https://github.com/jasonacox
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2.1 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+
+#ifndef __TM1637USI__
+#define __TM1637USI__
+
+#include <inttypes.h>
+#include "TM1637TinyDisplayConfig.h"
+
+#if TM1637_ENABLE_USI
+
+// USI pins in two-wire mode
+#if defined(__AVR_ATtiny25__) || defined(__AVR_ATtiny45__) || defined(__AVR_ATtiny85__)
+#define USI_DDR   DDRB
+#define USI_PORT  PORTB
+#define USI_PIN   PINB
+#define USI_SDA   PB0
+#define USI_SCL   PB2
+#elif defined(__AVR_ATtiny24__) || defined(__AVR_ATtiny44__) || defined(__AVR_ATtiny84__)
+#define USI_DDR   DDRA
+#define USI_PORT  PORTA
+#define USI_PIN   PINA
+#define USI_SDA   PA6
+#define USI_SCL   PA4
+#endif
+
+// The USI shifts the data register in two-wire mode while the bus protocol
+// (start, stop and ACK clocks) is framed around it. SDA and SCL are open drain
+// in this mode, matching the TM1637 bus. The USI shifts MSB first, so bytes
+// are bit reversed to keep the LSB first order of the TM1637.
+class TM1637USI {
+
+public:
+  //! Check that the display is wired to the USI pins
+  //!
+  //! @param pinClk The pin connected to CLK (must be the USI SCL pin)
+  //! @param pinDIO The pin connected to DIO (must be the USI SDA pin)
+  //! @return true if the USI can drive the display
+  static bool begin(uint8_t pinClk, uint8_t pinDIO);
+
+  //! Enable the USI and send a start condition
+  static void start(unsigned int bitDelay);
+
+  //! Send a stop condition and release the pins back to inputs
+  static void stop(unsigned int bitDelay);
+
+  //! Shift a byte out through the USI followed by the ACK clock
+  //!
+  //! @return The ACK bit (0 if the display acknowledged)
+  static bool writeByte(uint8_t b, unsigned int bitDelay);
+
+private:
+  static void clock(uint8_t edges, unsigned int bitDelay);
+};
+
+#endif // TM1637_ENABLE_USI
+
+#endif // __TM1637USI__
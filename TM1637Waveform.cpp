@@ -0,0 +1,163 @@
+//  TM1637 Tiny Display
+//  Precompiled TM1637 bus waveforms
+//
+//  Author: Jason A. Cox - @jasonacox - https://github.com/jasonacox
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2.1 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+
+#include <TM1637Waveform.h>
+#include <Arduino.h>
+
+TM1637Waveform::TM1637Waveform()
+{
+  clear();
+}
+
+void TM1637Waveform::clear()
+{
+  m_length = 0;
+  m_last = WAVE_IDLE;
+  m_overflow = false;
+}
+
+bool TM1637Waveform::append(uint8_t state)
+{
+  if (m_length >= TM1637_WAVEFORM_MAX_STATES) {
+    m_overflow = true;
+    return false;
+  }
+  // 4 line states per byte, 2 bits each
+  uint8_t shift = (m_length & 0x03) * 2;
+  uint8_t *p = &m_states[m_length >> 2];
+  *p = (*p & ~(0x03 << shift)) | ((state & WAVE_IDLE) << shift);
+  m_length++;
+  m_last = state;
+  return true;
+}
+
+bool TM1637Waveform::start()
+{
+  // DIO low while CLK is high
+  return append(WAVE_CLK);
+}
+
+bool TM1637Waveform::stop()
+{
+  // DIO low, CLK high then DIO high
+  bool ok = append(0);
+  ok &= append(WAVE_CLK);
+  ok &= append(WAVE_IDLE);
+  return ok;
+}
+
+bool TM1637Waveform::write(uint8_t b)
+{
+  bool ok = true;
+
+  // 8 Data Bits
+  for (uint8_t i = 0; i < 8; i++) {
+    uint8_t dio = (b & 0x01) ? WAVE_DIO : 0;
+    ok &= append(m_last & WAVE_DIO);   // CLK low
+    ok &= append(dio);                 // Set data bit
+    ok &= append(WAVE_CLK | dio);      // CLK high
+    b = b >> 1;
+  }
+
+  // ACK clock - DIO released for the display to pull low
+  ok &= append(WAVE_DIO);
+  ok &= append(WAVE_IDLE);
+  ok &= append(WAVE_DIO);
+  return ok;
+}
+
+uint16_t TM1637Waveform::length() const
+{
+  return m_length;
+}
+
+bool TM1637Waveform::overflow() const
+{
+  return m_overflow;
+}
+
+uint8_t TM1637Waveform::state(uint16_t i) const
+{
+  return (m_states[i >> 2] >> ((i & 0x03) * 2)) & WAVE_IDLE;
+}
+
+void TM1637Waveform::play(uint8_t pinClk, uint8_t pinDIO, unsigned int bitDelay) const
+{
+#ifdef __AVR__
+  // Resolve the data direction registers once - a set DDR bit drives the line low
+  volatile uint8_t *clkDDR = portModeRegister(digitalPinToPort(pinClk));
+  volatile uint8_t *dioDDR = portModeRegister(digitalPinToPort(pinDIO));
+  uint8_t clkMask = digitalPinToBitMask(pinClk);
+  uint8_t dioMask = digitalPinToBitMask(pinDIO);
+
+  for (uint16_t i = 0; i < m_length; i++) {
+    uint8_t s = state(i);
+    // The read-modify-write of the DDR must not be interrupted by an ISR that
+    // changes other pins of the same port
+    uint8_t sreg = SREG;
+    cli();
+    if (s & WAVE_CLK) *clkDDR &= ~clkMask; else *clkDDR |= clkMask;
+    if (s & WAVE_DIO) *dioDDR &= ~dioMask; else *dioDDR |= dioMask;
+    SREG = sreg;
+    delayMicroseconds(bitDelay);
+  }
+#else
+  for (uint16_t i = 0; i < m_length; i++) {
+    uint8_t s = state(i);
+    pinMode(pinClk, (s & WAVE_CLK) ? INPUT : OUTPUT);
+    pinMode(pinDIO, (s & WAVE_DIO) ? INPUT : OUTPUT);
+    delayMicroseconds(bitDelay);
+  }
+#endif
+}
+
+uint8_t TM1637Waveform::decode(uint8_t *bytes, uint8_t maxBytes) const
+{
+  uint8_t count = 0;
+  uint8_t prev = WAVE_IDLE;
+  uint8_t data = 0;
+  uint8_t bit = 0;
+  bool active = false;
+
+  for (uint16_t i = 0; i < m_length; i++) {
+    uint8_t s = state(i);
+    if ((prev & WAVE_CLK) && (s & WAVE_CLK)) {
+      // DIO change while CLK is high is a start or stop condition
+      if ((prev & WAVE_DIO) && !(s & WAVE_DIO)) {
+        active = true;
+        data = 0;
+        bit = 0;
+      }
+      else if (!(prev & WAVE_DIO) && (s & WAVE_DIO)) {
+        active = false;
+      }
+    }
+    else if (active && !(prev & WAVE_CLK) && (s & WAVE_CLK)) {
+      // Rising CLK edge - sample DIO, the 9th clock is the ACK
+      if (bit < 8) {
+        if (s & WAVE_DIO) data |= (1 << bit);
+        bit++;
+      }
+      else {
+        if (count < maxBytes) bytes[count] = data;
+        count++;
+        data = 0;
+        bit = 0;
+      }
+    }
+    prev = s;
+  }
+  return count < maxBytes ? count : maxBytes;
+}
@@ -0,0 +1,103 @@
+//  TM1637 Tiny Display
+//  Precompiled TM1637 bus waveforms
+//
+//  Author: Jason A. Cox - @jasonacox - https://github.com/jasonacox
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2.1 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+
+#ifndef __TM1637WAVEFORM__
+#define __TM1637WAVEFORM__
+
+#include <inttypes.h>
+
+// Line state bits - a set bit means the line is released (pulled high)
+#define WAVE_CLK    0x01
+#define WAVE_DIO    0x02
+#define WAVE_IDLE   (WAVE_CLK | WAVE_DIO)
+
+// Maximum number of line states in a waveform (4 states per byte of RAM).
+// A full 6-digit update (COMM1, COMM2 + 6 digits, COMM3) needs 255 states.
+#ifndef TM1637_WAVEFORM_MAX_STATES
+#define TM1637_WAVEFORM_MAX_STATES  256
+#endif
+
+class TM1637Waveform {
+
+public:
+  //! Initialize an empty waveform
+  TM1637Waveform();
+
+  //! Remove all line states
+  void clear();
+
+  //! Append a start condition (DIO falls while CLK is high)
+  //!
+  //! @return false if the waveform is full
+  bool start();
+
+  //! Append a stop condition (DIO rises while CLK is high)
+  //!
+  //! @return false if the waveform is full
+  bool stop();
+
+  //! Append a byte, LSB first, followed by the ACK clock
+  //!
+  //! Each bit takes three line states (CLK low, set DIO, CLK high) and the
+  //! ACK clock releases DIO for the display to acknowledge.
+  //!
+  //! @param b The byte to send
+  //! @return false if the waveform is full
+  bool write(uint8_t b);
+
+  //! Number of line states in the waveform
+  uint16_t length() const;
+
+  //! Returns true if any append did not fit into the waveform
+  bool overflow() const;
+
+  //! Line state at a given step
+  //!
+  //! @param i Index of the step (0 to length() - 1)
+  //! @return WAVE_CLK and WAVE_DIO bits for the step
+  uint8_t state(uint16_t i) const;
+
+  //! Play the waveform on the bus
+  //!
+  //! Streams the precompiled line states to the pins at a fixed period of
+  //! bitDelay microseconds per state. On AVR the port registers are resolved
+  //! once so each step is a direct register write.
+  //!
+  //! @param pinClk The pin connected to CLK
+  //! @param pinDIO The pin connected to DIO
+  //! @param bitDelay The delay in microseconds for each line state
+  void play(uint8_t pinClk, uint8_t pinDIO, unsigned int bitDelay) const;
+
+  //! Decode the waveform like a TM1637 would
+  //!
+  //! Walks the line states, detecting start/stop conditions and sampling DIO on
+  //! rising CLK edges. This allows a compiled waveform to be verified without
+  //! hardware.
+  //!
+  //! @param bytes Array receiving the decoded bytes of all transactions
+  //! @param maxBytes Size of the bytes array
+  //! @return Number of bytes decoded
+  uint8_t decode(uint8_t *bytes, uint8_t maxBytes) const;
+
+private:
+  bool append(uint8_t state);
+
+  uint8_t m_states[TM1637_WAVEFORM_MAX_STATES / 4];
+  uint16_t m_length;
+  uint8_t m_last;
+  bool m_overflow;
+};
+
+#endif // __TM1637WAVEFORM__
@@ -0,0 +1,53 @@
+//  TM1637TinyDisplay Footprint Sketch
+//  Prints the RAM used by a display object and the features compiled in
+//
+//  Build it once per feature configuration (see TM1637TinyDisplayConfig.h) to
+//  fill in a size matrix for your board: the object sizes come from the serial
+//  output and the flash used comes from the IDE (or avr-size) for the same build.
+//
+
+/* Set Display Digits - 4 or 6 */
+#define DIGITS 4
+
+#include <Arduino.h>
+#if DIGITS == 6
+  #include <TM1637TinyDisplay6.h>
+  typedef TM1637TinyDisplay6 Display;
+#else
+  #include <TM1637TinyDisplay.h>
+  typedef TM1637TinyDisplay Display;
+#endif
+
+// Feature name and setting
+void printFeature(const __FlashStringHelper *name, int enabled) {
+  Serial.print(name);
+  Serial.println(enabled ? F("1") : F("0"));
+}
+
+void setup() {
+  Serial.begin(9600);
+
+  Serial.print(F("DIGITS     "));
+  Serial.println(DIGITS);
+  Serial.print(F("sizeof     "));
+  Serial.println((unsigned int)sizeof(Display));
+
+  printFeature(F("ANIMATION "), TM1637_ENABLE_ANIMATION);
+  printFeature(F("SCROLL    "), TM1637_ENABLE_SCROLL);
+  printFeature(F("FLOAT     "), TM1637_ENABLE_FLOAT);
+  printFeature(F("FLIP      "), TM1637_ENABLE_FLIP);
+  printFeature(F("TIMER     "), TM1637_ENABLE_TIMER);
+  printFeature(F("METER     "), TM1637_ENABLE_METER);
+  printFeature(F("FULL_FONT "), TM1637_ENABLE_FULL_FONT);
+  printFeature(F("GLYPHS    "), TM1637_ENABLE_GLYPHS);
+  printFeature(F("CLOCK     "), TM1637_ENABLE_CLOCK);
+  printFeature(F("WAVEFORM  "), TM1637_ENABLE_WAVEFORM);
+  printFeature(F("USI       "), TM1637_ENABLE_USI);
+  printFeature(F("STATS     "), TM1637_ENABLE_STATS);
+  printFeature(F("CAPTURE   "), TM1637_ENABLE_CAPTURE);
+  printFeature(F("TIME_SRC  "), TM1637_ENABLE_TIME_SOURCE);
+  printFeature(F("FIXED_PINS"), TM1637_FIXED_PINS);
+}
+
+void loop() {
+}
@@ -0,0 +1,130 @@
+//  TM1637 Tiny Display - host tests
+//  Simulated TM1637 chip that decodes the bus driven through the pin functions
+//
+//  Author: Jason A. Cox - @jasonacox - https://github.com/jasonacox
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2.1 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+
+#include "TM1637Sim.h"
+#include <Arduino.h>
+
+TM1637Sim *TM1637Sim::active = nullptr;
+
+TM1637Sim::TM1637Sim(uint8_t pinClk, uint8_t pinDIO)
+{
+  m_pinClk = pinClk;
+  m_pinDIO = pinDIO;
+  reset();
+  active = this;
+}
+
+TM1637Sim::~TM1637Sim()
+{
+  if (active == this) active = nullptr;
+}
+
+void TM1637Sim::reset()
+{
+  memset(ram, 0, sizeof(ram));
+  control = 0x80;
+  transactions = 0;
+  bytes = 0;
+  m_clkLow = false;
+  m_dioLow = false;
+  m_ack = false;
+  m_active = false;
+  m_bit = 0;
+  m_byte = 0;
+  m_count = 0;
+  m_fixed = false;
+}
+
+bool TM1637Sim::clkHigh() const
+{
+  return !m_clkLow;
+}
+
+bool TM1637Sim::dioHigh() const
+{
+  return !m_dioLow && !m_ack;
+}
+
+void TM1637Sim::pinMode(uint8_t pin, uint8_t mode)
+{
+  bool clk = clkHigh();
+  bool dio = dioHigh();
+  if (pin == m_pinClk) m_clkLow = (mode == OUTPUT);
+  else if (pin == m_pinDIO) m_dioLow = (mode == OUTPUT);
+  else return;
+
+  if (clk && !clkHigh() && m_active) {
+    // Falling CLK edge - the chip drives the acknowledge during the 9th clock
+    m_ack = (m_bit == 8);
+  }
+
+  if (clk && clkHigh()) {
+    // DIO change while CLK is high is a start or stop condition
+    if (dio && !dioHigh()) {
+      m_active = true;
+      m_bit = 0;
+      m_byte = 0;
+      m_count = 0;
+    }
+    else if (!dio && dioHigh() && m_active) {
+      m_active = false;
+      command();
+    }
+  }
+  else if (!clk && clkHigh() && m_active) {
+    // Rising CLK edge - sample DIO, LSB first, the 9th clock is the acknowledge
+    if (m_bit < 8) {
+      if (dioHigh()) m_byte |= 1 << m_bit;
+      m_bit++;
+    }
+    else {
+      if (m_count < sizeof(m_data)) m_data[m_count++] = m_byte;
+      bytes++;
+      m_bit = 0;
+      m_byte = 0;
+    }
+  }
+}
+
+int TM1637Sim::digitalRead(uint8_t pin)
+{
+  if (pin == m_pinDIO) return dioHigh() ? HIGH : LOW;
+  return clkHigh() ? HIGH : LOW;
+}
+
+void TM1637Sim::command()
+{
+  if (m_count == 0) return;
+  transactions++;
+  uint8_t c = m_data[0];
+  switch (c & 0xC0) {
+    case 0x40: // Data command - bit 2 selects fixed addressing
+      m_fixed = c & 0x04;
+      break;
+    case 0x80: // Display control
+      control = c;
+      break;
+    case 0xC0: { // Address command followed by the data bytes
+      uint8_t addr = c & 0x07;
+      for (uint8_t i = 1; i < m_count; i++) {
+        if (addr < SIM_RAM_SIZE) ram[addr] = m_data[i];
+        // The address counter wraps after the last grid, which the 6-digit
+        // class relies on when it starts its frame at address 3
+        if (!m_fixed) addr = (addr + 1) % SIM_RAM_SIZE;
+      }
+      break;
+    }
+  }
+}
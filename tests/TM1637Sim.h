@@ -0,0 +1,72 @@
+//  TM1637 Tiny Display - host tests
+//  Simulated TM1637 chip that decodes the bus driven through the pin functions
+//
+//  Author: Jason A. Cox - @jasonacox - https://github.com/jasonacox
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2.1 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  The bus is open drain: pinMode(OUTPUT) pulls a line low and pinMode(INPUT)
+//  releases it. The simulation follows start/stop conditions, clocks in the
+//  bytes on rising CLK edges, pulls DIO low for the acknowledge and applies the
+//  data and display control commands to its display RAM.
+
+#ifndef __TM1637SIM__
+#define __TM1637SIM__
+
+#include <stdint.h>
+
+#define SIM_RAM_SIZE    6
+
+class TM1637Sim {
+
+public:
+  //! Attach the chip to two pins (it becomes the chip the pin functions drive)
+  TM1637Sim(uint8_t pinClk, uint8_t pinDIO);
+  ~TM1637Sim();
+
+  //! Power-on state: RAM cleared, display off, auto-increment addressing
+  void reset();
+
+  //! Display RAM, indexed by address
+  uint8_t ram[SIM_RAM_SIZE];
+
+  //! Last display control command (0x80 | on << 3 | brightness)
+  uint8_t control;
+
+  //! Completed transactions and bytes acknowledged
+  unsigned long transactions;
+  unsigned long bytes;
+
+  // Called by the host pin functions
+  void pinMode(uint8_t pin, uint8_t mode);
+  int digitalRead(uint8_t pin);
+
+  static TM1637Sim *active;
+
+private:
+  bool clkHigh() const;
+  bool dioHigh() const;
+  void command();
+
+  uint8_t m_pinClk;
+  uint8_t m_pinDIO;
+  bool m_clkLow;
+  bool m_dioLow;
+  bool m_ack;
+  bool m_active;
+  uint8_t m_bit;
+  uint8_t m_byte;
+  uint8_t m_count;
+  uint8_t m_data[SIM_RAM_SIZE + 1];
+  bool m_fixed;
+};
+
+#endif // __TM1637SIM__
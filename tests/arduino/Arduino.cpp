@@ -0,0 +1,55 @@
+//  TM1637 Tiny Display - host tests
+//  Host implementation of the Arduino core functions used by the library
+//
+//  Author: Jason A. Cox - @jasonacox - https://github.com/jasonacox
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2.1 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+
+#include <Arduino.h>
+#include "../TM1637Sim.h"
+
+static unsigned long hostMs = 0;
+static unsigned long hostUs = 0;
+
+void pinMode(uint8_t pin, uint8_t mode)
+{
+  if (TM1637Sim::active != nullptr) TM1637Sim::active->pinMode(pin, mode);
+}
+
+void digitalWrite(uint8_t, uint8_t)
+{
+}
+
+int digitalRead(uint8_t pin)
+{
+  if (TM1637Sim::active != nullptr) return TM1637Sim::active->digitalRead(pin);
+  return HIGH;
+}
+
+unsigned long millis()
+{
+  return hostMs;
+}
+
+unsigned long micros()
+{
+  return hostUs;
+}
+
+void delay(unsigned long ms)
+{
+  hostMs += ms;
+}
+
+void delayMicroseconds(unsigned int us)
+{
+  hostUs += us;
+}
@@ -0,0 +1,55 @@
+//  TM1637 Tiny Display - host tests
+//  Minimal stand-in for the Arduino core so the library builds on the host
+//
+//  Author: Jason A. Cox - @jasonacox - https://github.com/jasonacox
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2.1 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+
+#ifndef __ARDUINO_HOST__
+#define __ARDUINO_HOST__
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#define INPUT           0x0
+#define OUTPUT          0x1
+#define INPUT_PULLUP    0x2
+#define LOW             0x0
+#define HIGH            0x1
+
+#define PROGMEM
+#define PSTR(s)         (s)
+#define strlen_P        strlen
+#define memcpy_P        memcpy
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+// Pins are routed to the simulated chip (see TM1637Sim.h)
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t val);
+int digitalRead(uint8_t pin);
+
+// Host time only moves when the library waits, tests use a TM1637TimeSource
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+
+inline void yield() {}
+inline void noInterrupts() {}
+inline void interrupts() {}
+
+#include "Print.h"
+
+#endif // __ARDUINO_HOST__
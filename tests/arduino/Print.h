@@ -0,0 +1,66 @@
+//  TM1637 Tiny Display - host tests
+//  Print and Stream classes of the Arduino core for the host build
+//
+//  Author: Jason A. Cox - @jasonacox - https://github.com/jasonacox
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2.1 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+
+#ifndef __PRINT_HOST__
+#define __PRINT_HOST__
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+class Print {
+public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t c) = 0;
+  virtual size_t write(const uint8_t *buffer, size_t size) {
+    size_t n = 0;
+    while (size--) n += write(*buffer++);
+    return n;
+  }
+  size_t write(const char *s) { return write((const uint8_t *)s, strlen(s)); }
+  virtual void flush() {}
+
+  size_t print(const char s[]) { return write(s); }
+  size_t print(char c) { return write((uint8_t)c); }
+  size_t print(unsigned long n, int base = 10) {
+    char buf[8 * sizeof(n) + 1];
+    char *p = buf + sizeof(buf) - 1;
+    *p = 0;
+    do {
+      uint8_t d = n % base;
+      *--p = d < 10 ? '0' + d : 'A' + d - 10;
+      n /= base;
+    } while (n);
+    return write(p);
+  }
+  size_t print(long n, int base = 10) {
+    if (n < 0 && base == 10) return print('-') + print(0UL - (unsigned long)n, base);
+    return print((unsigned long)n, base);
+  }
+  size_t print(unsigned int n, int base = 10) { return print((unsigned long)n, base); }
+  size_t print(int n, int base = 10) { return print((long)n, base); }
+  size_t print(unsigned char n, int base = 10) { return print((unsigned long)n, base); }
+  size_t println() { return write("\r\n"); }
+  size_t println(const char s[]) { return print(s) + println(); }
+};
+
+class Stream : public Print {
+public:
+  virtual int available() = 0;
+  virtual int read() = 0;
+  virtual int peek() = 0;
+};
+
+#endif // __PRINT_HOST__
@@ -0,0 +1,38 @@
+//  TM1637 Tiny Display - host tests
+//  Minimal checks shared by the test programs
+//
+//  Author: Jason A. Cox - @jasonacox - https://github.com/jasonacox
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2.1 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+
+#ifndef __TM1637TEST__
+#define __TM1637TEST__
+
+#include <stdio.h>
+
+static int testFailures = 0;
+
+// Report a failed condition and keep going
+#define CHECK(cond) do { \
+    if (!(cond)) { \
+      printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+      testFailures++; \
+    } \
+  } while (0)
+
+// Summary line and exit code of a test program
+static inline int testResult(const char *name)
+{
+  printf("%s: %s\n", name, testFailures ? "FAILED" : "passed");
+  return testFailures ? 1 : 0;
+}
+
+#endif // __TM1637TEST__
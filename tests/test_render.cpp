@@ -0,0 +1,205 @@
+//  TM1637 Tiny Display - host tests
+//  Golden frames of the public display functions: each case drives the library,
+//  renders the simulated chip's display RAM with TM1637Render and the whole
+//  output is compared byte for byte with golden/render4.txt (render6.txt)
+//
+//  Author: Jason A. Cox - @jasonacox - https://github.com/jasonacox
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2.1 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  Run "make golden" after an intended rendering change and review the diff.
+
+#include <Arduino.h>
+#include <stdio.h>
+#include <string>
+#if TEST_DIGITS == 6
+#include <TM1637TinyDisplay6.h>
+typedef TM1637TinyDisplay6 Display;
+#define GOLDEN_FILE   "golden/render6.txt"
+#define RAM_ORDER     TM1637Render::addressOrder6
+#else
+#include <TM1637TinyDisplay.h>
+typedef TM1637TinyDisplay Display;
+#define GOLDEN_FILE   "golden/render4.txt"
+#define RAM_ORDER     nullptr
+#endif
+#include <TM1637Render.h>
+#include <TM1637Print.h>
+#include "TM1637Sim.h"
+#include "test.h"
+
+#define CLK   4
+#define DIO   5
+
+// Collects printed text in a string
+class TextPrint : public Print {
+public:
+  size_t write(uint8_t c) { text += (char)c; return 1; }
+  std::string text;
+};
+
+// Append the name, the display RAM in address order with the display control
+// and the rendered digits of the simulated chip
+static void render(TextPrint &out, const TM1637Sim &chip, const char *name)
+{
+  char line[80];
+  int n = snprintf(line, sizeof(line), "%s:", name);
+  for (uint8_t k = 0; k < SIM_RAM_SIZE; k++) n += snprintf(line + n, sizeof(line) - n, " %02x", chip.ram[k]);
+  snprintf(line + n, sizeof(line) - n, " | %02x\r\n", chip.control);
+  out.print(line);
+  TM1637Render::print(out, chip.ram, MAXDIGITS, chip.control, RAM_ORDER);
+}
+
+static void cases(TextPrint &out)
+{
+  TM1637Sim chip(CLK, DIO);
+  Display display(CLK, DIO);
+  display.begin();
+  render(out, chip, "begin");
+
+  display.showNumber(1234);
+  render(out, chip, "showNumber(1234)");
+  display.showNumber(-12);
+  render(out, chip, "showNumber(-12)");
+  display.showNumber(7, true);
+  render(out, chip, "showNumber(7, leading_zero)");
+  display.showNumber(42, false, 2, 1);
+  render(out, chip, "showNumber(42, length 2, pos 1)");
+  display.showNumber(3.14159);
+  render(out, chip, "showNumber(3.14159)");
+  display.showNumber(-0.5, 2);
+  render(out, chip, "showNumber(-0.5, 2 decimals)");
+  display.showNumberDec(1234, 0b01000000);
+  render(out, chip, "showNumberDec(1234, colon)");
+  display.showNumberHex(0xBEEF);
+  render(out, chip, "showNumberHex(0xBEEF)");
+
+  display.showString("HELP");
+  render(out, chip, "showString(HELP)");
+  display.showString("Hi.5");
+  render(out, chip, "showString(Hi.5)");
+  display.showString("ab", 2, 2);
+  render(out, chip, "showString(ab, length 2, pos 2)");
+  display.showString("23\xc2\xb0" "C");
+  render(out, chip, "showString(23 degrees C)");
+  display.showString("-_=]");
+  render(out, chip, "showString(-_=])");
+  display.showFormat("%.1f", 2.5);
+  render(out, chip, "showFormat(%.1f, 2.5)");
+  display.showFormat("%x", 0xbd);
+  render(out, chip, "showFormat(%x, 0xbd)");
+  display.showFormat("%x", 0xace);
+  render(out, chip, "showFormat(%x, 0xace)");
+  display.showFormat("%X", 0xace);
+  render(out, chip, "showFormat(%X, 0xace)");
+  display.showFormat("%.200d", 7);
+  render(out, chip, "showFormat(%.200d, 7)");
+
+  for (unsigned int level = 0; level <= 100; level += 25) {
+    char name[32];
+    display.showLevel(level);
+    snprintf(name, sizeof(name), "showLevel(%u)", level);
+    render(out, chip, name);
+    display.showLevel(level, false);
+    snprintf(name, sizeof(name), "showLevel(%u, vertical)", level);
+    render(out, chip, name);
+  }
+
+  static const uint8_t orientations[] = {
+    ORIENTATION_FLIP, ORIENTATION_MIRROR, ORIENTATION_MIRROR_V, ORIENTATION_NORMAL
+  };
+  static const char *names[] = { "flip", "mirror", "mirror_v", "normal" };
+  for (uint8_t i = 0; i < 4; i++) {
+    char name[48];
+    display.setOrientation(orientations[i]);
+    display.showString("1.2E");
+    snprintf(name, sizeof(name), "setOrientation(%s) showString(1.2E)", names[i]);
+    render(out, chip, name);
+    display.showNumber(-98);
+    snprintf(name, sizeof(name), "setOrientation(%s) showNumber(-98)", names[i]);
+    render(out, chip, name);
+  }
+  display.flipDisplay(true);
+  display.showNumberDec(1200, 0b01000000);
+  render(out, chip, "flipDisplay(true) showNumberDec(1200, colon)");
+  display.flipDisplay(false);
+
+  // Print adapter decodes UTF-8 like showString()
+  TM1637Print<Display> lcd(display);
+  lcd.print("23\xc2\xb0" "C");
+  render(out, chip, "TM1637Print print(23 degrees C)");
+  lcd.clear();
+  lcd.print("-1.5");
+  render(out, chip, "TM1637Print print(-1.5)");
+
+  // Custom glyphs keyed by code point, Latin-1 letters keep their fallbacks
+  static const uint8_t cyrillicSegments[] PROGMEM = { 0x77, 0x7d, 0x7f, 0x31, 0x5f };
+  static const TM1637Glyphs cyrillic = { 0x410, 5, 1, cyrillicSegments };
+  static const uint8_t wideM[] PROGMEM = { 0x33, 0x27 };
+  static const TM1637Glyphs m = { 'M', 1, 2, wideM };
+  TM1637Font::addGlyphs(cyrillic);
+  TM1637Font::addGlyphs(m);
+  display.showString("\xd0\x91\xd0\x92\xd0\x93");
+  render(out, chip, "addGlyphs showString(Cyrillic)");
+  display.showString("\xc3\x80\xc3\x81\xc3\x84");
+  render(out, chip, "addGlyphs showString(Latin-1 A)");
+  display.showFormat("M%d", 4);
+  render(out, chip, "addGlyphs showFormat(M%d, 4)");
+  TM1637Font::clearGlyphs();
+
+  display.setBrightness(2);
+  display.showString("dim");
+  render(out, chip, "setBrightness(2)");
+  display.setBrightness(7, false);
+  render(out, chip, "setBrightness(7, off)");
+  display.setBrightness(BRIGHT_HIGH);
+  display.clear();
+  render(out, chip, "clear");
+}
+
+int main(int argc, char **argv)
+{
+  TextPrint out;
+  cases(out);
+
+  if (argc > 1 && strcmp(argv[1], "--update") == 0) {
+    FILE *f = fopen(GOLDEN_FILE, "wb");
+    CHECK(f != nullptr);
+    if (f) {
+      fwrite(out.text.data(), 1, out.text.size(), f);
+      fclose(f);
+      printf("wrote %s\n", GOLDEN_FILE);
+    }
+    return testResult("test_render");
+  }
+
+  std::string golden;
+  FILE *f = fopen(GOLDEN_FILE, "rb");
+  CHECK(f != nullptr);
+  if (f) {
+    char buf[256];
+    size_t n;
+    while ((n = fread(buf, 1, sizeof(buf), f)) > 0) golden.append(buf, n);
+    fclose(f);
+  }
+
+  // Report the first case that differs
+  if (golden != out.text) {
+    size_t pos = 0;
+    while (pos < golden.size() && pos < out.text.size() && golden[pos] == out.text[pos]) pos++;
+    size_t start = out.text.rfind('\n', pos ? pos - 1 : 0);
+    start = (start == std::string::npos) ? 0 : start + 1;
+    printf("%s differs at byte %zu:\n%s\n", GOLDEN_FILE, pos,
+      out.text.substr(start, 4 * (MAXDIGITS * 4 + 2) + 80).c_str());
+  }
+  CHECK(golden == out.text);
+  return testResult(TEST_DIGITS == 6 ? "test_render (6 digits)" : "test_render");
+}
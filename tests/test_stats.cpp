@@ -0,0 +1,85 @@
+//  TM1637 Tiny Display - host tests
+//  Operation counters of the statistics and the estimate from a cost table
+//
+//  Author: Jason A. Cox - @jasonacox - https://github.com/jasonacox
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2.1 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+
+#include <Arduino.h>
+#if TEST_DIGITS == 6
+#include <TM1637TinyDisplay6.h>
+typedef TM1637TinyDisplay6 Display;
+#else
+#include <TM1637TinyDisplay.h>
+typedef TM1637TinyDisplay Display;
+#endif
+#include "TM1637Sim.h"
+#include "test.h"
+
+#define CLK   4
+#define DIO   5
+
+static const char text_P[] PROGMEM = "AB";
+
+int main()
+{
+  TM1637Sim chip(CLK, DIO);
+  Display display(CLK, DIO);
+  display.begin();
+  TM1637Stats stats = display.getStats();
+  CHECK(stats.pinAccesses > 0);
+  CHECK(stats.bitDelays > 0);
+
+  // Four digits: one divide per digit to count them, a divide and a modulo per
+  // digit to render them and one font lookup per digit
+  display.resetStats();
+  display.showNumber(1234);
+  stats = display.getStats();
+  CHECK(stats.divides == 12);
+  CHECK(stats.progmemReads == 4);
+
+  // A RAM string reads only the font, a PROGMEM string also its bytes
+  display.resetStats();
+  display.showString("AB");
+  CHECK(display.getStats().progmemReads == 2);
+  display.resetStats();
+  display.showString_P(text_P);
+  CHECK(display.getStats().progmemReads == 4);
+  CHECK(display.getStats().divides == 0);
+
+  // The estimate adds the cycles of every counted operation to the delays
+  display.resetStats();
+  display.showNumber(56);
+  stats = display.getStats();
+  TM1637CostTable costs = { 10, 20, 30, 5, 16 };
+  unsigned long cycles = stats.pinAccesses * 10 + stats.bitDelays * 20
+                       + stats.divides * 30 + stats.progmemReads * 5;
+  CHECK(stats.estimateUs(costs) == cycles / 16 + stats.delayUs);
+  CHECK(stats.estimateUs(costs) > stats.delayUs);
+
+  // Without a clock only the requested delays are known
+  TM1637CostTable unknown = { 10, 20, 30, 5, 0 };
+  CHECK(stats.estimateUs(unknown) == stats.delayUs);
+
+  // Frames sent without writeBuffer() are timed as writeBuffer() too
+  static const uint8_t frame[MAXDIGITS] = { 0x06, 0x5b, 0x4f, 0x66 };
+  display.resetStats();
+  display.setFrame(frame);
+  CHECK(display.getStats().calls[STATS_WRITEBUFFER] == 1);
+  display.showTime(12, 34, 56);
+  display.resetStats();
+  display.showTime(12, 35, 56);
+  stats = display.getStats();
+  CHECK(stats.calls[STATS_WRITEBUFFER] == 1);
+  CHECK(stats.transactions == 2);
+
+  return testResult(TEST_DIGITS == 6 ? "test_stats (6 digits)" : "test_stats");
+}
@@ -0,0 +1,128 @@
+//  TM1637 Tiny Display - host tests
+//  Animations, scrolling, blink, timer and meter driven by a virtual clock that
+//  wraps at 2^32 must show exactly the same frames as a clock started at zero
+//
+//  Author: Jason A. Cox - @jasonacox - https://github.com/jasonacox
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2.1 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+
+#include <Arduino.h>
+#include <string>
+#if TEST_DIGITS == 6
+#include <TM1637TinyDisplay6.h>
+typedef TM1637TinyDisplay6 Display;
+#else
+#include <TM1637TinyDisplay.h>
+typedef TM1637TinyDisplay Display;
+#endif
+#include "TM1637Sim.h"
+#include "test.h"
+
+#define CLK   4
+#define DIO   5
+
+// Start of the clock a little before it wraps, every phase runs across the wrap
+#define WRAP_START    (0xFFFFFFFFUL - 250)
+
+static uint32_t virtualMs;
+static uint32_t virtualNow() { return virtualMs; }
+static void virtualWait(uint32_t ms) { virtualMs += ms; }
+static const TM1637TimeSource virtualClock = { virtualNow, virtualWait };
+
+static const uint8_t frames[4][MAXDIGITS] = {
+  { 0x01 }, { 0x02, 0x02 }, { 0x04, 0x04, 0x04 }, { 0x08, 0x08, 0x08, 0x08 }
+};
+
+// Append the display RAM and a value to the log
+static void snapshot(std::string &log, const TM1637Sim &chip, unsigned long value)
+{
+  char line[64];
+  int n = 0;
+  for (uint8_t k = 0; k < SIM_RAM_SIZE; k++) n += snprintf(line + n, sizeof(line) - n, "%02x ", chip.ram[k]);
+  snprintf(line + n, sizeof(line) - n, "%lu\n", value);
+  log += line;
+}
+
+// Run one phase with the clock starting at start and return what was shown
+static std::string phase(uint8_t which, uint32_t start)
+{
+  TM1637Sim chip(CLK, DIO);
+  Display display(CLK, DIO);
+  std::string log;
+
+  virtualMs = start;
+  display.setTimeSource(&virtualClock);
+  display.begin();
+
+  switch (which) {
+    case 0: // Frame animation, including the time to the next frame
+      display.startAnimation(frames, 4, 100);
+      for (int i = 0; i < 12; i++) {
+        bool running = display.Animate();
+        snapshot(log, chip, running * 1000 + display.nextDeadlineMs());
+        virtualMs += 30;
+      }
+      break;
+    case 1: // String scroll
+      display.startStringScroll("WRAP 1234", 100);
+      for (int i = 0; i < 40; i++) {
+        snapshot(log, chip, display.Animate());
+        virtualMs += 50;
+      }
+      break;
+    case 2: // Blinking digits and decimal points
+      display.showNumber(1234);
+      display.setBlink(0b10100000, 0b01000000, 120);
+      for (int i = 0; i < 20; i++) {
+        snapshot(log, chip, display.Animate());
+        virtualMs += 40;
+      }
+      break;
+    case 3: // Countdown timer
+      display.startTimer(1500);
+      for (int i = 0; i < 20; i++) {
+        display.Animate();
+        snapshot(log, chip, display.readTimer());
+        virtualMs += 100;
+      }
+      break;
+    case 4: // Level meter with peak hold and decay
+      display.startMeter(100, METER_BAR | METER_PEAK, 10);
+      display.setMeterDynamics(0, 64, 100);
+      for (int i = 0; i < 40; i++) {
+        display.meterSample(i < 5 ? 100 : 10);
+        display.Animate();
+        snapshot(log, chip, 0);
+        virtualMs += 20;
+      }
+      break;
+    case 5: // Blocking animation waits through the time source
+      display.showAnimation(frames, 4, 100);
+      snapshot(log, chip, virtualMs - start);
+      break;
+  }
+  return log;
+}
+
+int main()
+{
+  static const char *names[] = { "animation", "scroll", "blink", "timer", "meter", "wait" };
+  for (uint8_t which = 0; which < 6; which++) {
+    std::string reference = phase(which, 0);
+    std::string wrapped = phase(which, WRAP_START);
+    if (reference != wrapped) {
+      printf("%s differs across the clock wrap\n--- from 0\n%s--- from 0x%08lx\n%s",
+        names[which], reference.c_str(), (unsigned long)WRAP_START, wrapped.c_str());
+    }
+    CHECK(reference == wrapped);
+  }
+  return testResult(TEST_DIGITS == 6 ? "test_time_source (6 digits)" : "test_time_source");
+}